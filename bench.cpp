@@ -0,0 +1,214 @@
+#include "error.h"
+#include "data.h"
+#include "client.h"
+#include "loopback.h"
+#include "stats.h"
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * @brief Форма синтетических входных данных.
+ */
+struct Shape
+{
+    uint32_t count;  ///< Количество векторов.
+    uint32_t length; ///< Длина каждого вектора.
+};
+
+// Пароль, общий для клиента и локального сервера
+static const char BENCH_PASSWORD[] = "P@ssW0rd";
+
+/**
+ * @brief Формирует синтетический набор векторов.
+ * 
+ * @param shape Форма набора.
+ * @return Набор векторов с детерминированными значениями.
+ */
+static VectorBatch GenerateVectors(const Shape &shape)
+{
+    VectorBatch data;
+    data.reserve(shape.count, size_t(shape.count) * shape.length);
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (size_t i = 0; i < shape.count; ++i)
+    {
+        data.append(shape.length);
+        double *values = data.data(i);
+        for (size_t j = 0; j < shape.length; ++j)
+        {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            values[j] = double(state >> 11) / double(1ull << 53) - 0.5;
+        }
+    }
+    return data;
+}
+
+/**
+ * @brief Записывает набор векторов во входной файл в формате клиента.
+ * 
+ * @param path Путь к файлу.
+ * @param data Набор векторов.
+ * @throws RuntimeError Если файл не удалось записать.
+ */
+static void WriteInput(const string &path, const VectorBatch &data)
+{
+    ofstream file(path, ios::binary);
+    uint32_t count = data.size();
+    file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    for (const auto &vec : data)
+    {
+        uint32_t size = vec.size();
+        file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+        file.write(reinterpret_cast<const char *>(vec.data()), size * sizeof(double));
+    }
+    if (!file)
+    {
+        throw RuntimeError("Failed to write benchmark input \"" + path + "\"", __func__);
+    }
+}
+
+/**
+ * @brief Многократно выполняет замеряемое действие.
+ * 
+ * @param iterations Количество повторов.
+ * @param action Замеряемое действие.
+ * @return Замеры всех повторов.
+ */
+static LatencyStats Measure(size_t iterations, const function<void()> &action)
+{
+    LatencyStats stats;
+    action(); // Прогрев кешей и аллокатора
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        Stopwatch watch;
+        action();
+        stats.add(watch.elapsed());
+    }
+    return stats;
+}
+
+/**
+ * @brief Печатает строку отчёта.
+ * 
+ * @param name Название замера.
+ * @param shape Форма входных данных.
+ * @param stats Замеры.
+ * @param items Количество обработанных единиц за один повтор.
+ * @param unit Название единицы ("vec", "auth").
+ * @param bytes Объём данных, обрабатываемый за один повтор (0, если неприменимо).
+ */
+static void Report(const string &name, const Shape &shape, const LatencyStats &stats, size_t items, const string &unit,
+                   size_t bytes)
+{
+    ostringstream throughput;
+    double mean = stats.mean();
+    if (mean > 0)
+    {
+        throughput << fixed << setprecision(0) << items / mean << " " << unit << "/s";
+        if (bytes > 0)
+        {
+            throughput << ", " << setprecision(1) << bytes / mean / (1 << 20) << " MiB/s";
+        }
+    }
+
+    ostringstream form;
+    form << shape.count << "x" << shape.length;
+    cout << left << setw(14) << name << setw(12) << form.str()
+         << right << setw(12) << FormatDuration(stats.percentile(50))
+         << setw(12) << FormatDuration(stats.percentile(99))
+         << setw(12) << FormatDuration(stats.percentile(100))
+         << "   " << throughput.str() << endl;
+}
+
+/**
+ * @brief Главная функция набора микробенчмарков.
+ * 
+ * Для каждой формы входных данных замеряет чтение и запись файлов, вывод векторов,
+ * подключение с аутентификацией и вычисление на локальном сервере LoopbackServer.
+ * 
+ * @param argc Количество аргументов.
+ * @param argv Аргументы: необязательное количество повторов (по умолчанию 20).
+ * @return Код завершения программы.
+ */
+int main(int argc, char *argv[])
+{
+    try
+    {
+        size_t iterations = argc > 1 ? strtoul(argv[1], nullptr, 10) : 20;
+        if (iterations == 0)
+        {
+            throw RuntimeError("Number of iterations must be positive", __func__);
+        }
+
+        const vector<Shape> shapes = {{1000, 16}, {1000, 1024}, {100000, 16}, {100, 65536}};
+        string prefix = "/tmp/vclient-bench-" + to_string(getpid());
+        string input_path = prefix + ".in";
+        string output_path = prefix + ".out";
+
+        LoopbackServer server(BENCH_PASSWORD);
+        server.start();
+
+        // Вывод PrintVectors() отбрасывается, замеряется только форматирование
+        ofstream null_stream("/dev/null");
+
+        cout << left << setw(14) << "benchmark" << setw(12) << "shape"
+             << right << setw(12) << "p50" << setw(12) << "p99" << setw(12) << "max"
+             << "   throughput" << endl;
+
+        for (const auto &shape : shapes)
+        {
+            VectorBatch data = GenerateVectors(shape);
+            size_t payload = size_t(shape.count) * (sizeof(uint32_t) + shape.length * sizeof(double));
+            WriteInput(input_path, data);
+            DataHandler handler("", input_path, output_path);
+
+            Report("readData", shape, Measure(iterations, [&]()
+                                              { handler.readData(); }),
+                   shape.count, "vec", payload);
+
+            vector<double> results(shape.count, 1.0);
+            Report("writeData", shape, Measure(iterations, [&]()
+                                               { handler.writeData(results); }),
+                   shape.count, "vec", results.size() * sizeof(double));
+
+            streambuf *saved = cout.rdbuf(null_stream.rdbuf());
+            LatencyStats print_stats = Measure(iterations, [&]()
+                                               { PrintVectors(data); });
+            cout.rdbuf(saved);
+            Report("PrintVectors", shape, print_stats, shape.count, "vec", 0);
+
+            Report("authenticate", shape, Measure(iterations, [&]()
+                                                  {
+                Client client("127.0.0.1", server.getPort());
+                client.connectToServer();
+                client.authenticate("user", BENCH_PASSWORD);
+                client.closeConnection(); }),
+                   1, "auth", 0);
+
+            Client client("127.0.0.1", server.getPort());
+            client.connectToServer();
+            client.authenticate("user", BENCH_PASSWORD);
+            Report("calculate", shape, Measure(iterations, [&]()
+                                               { client.submit(data, 0, data.size()); }),
+                   shape.count, "vec", payload);
+            client.closeConnection();
+        }
+
+        server.stop();
+        unlink(input_path.c_str());
+        unlink(output_path.c_str());
+    }
+    catch (const RuntimeError &e)
+    {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
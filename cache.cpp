@@ -0,0 +1,184 @@
+#include "cache.h"
+#include <fstream>
+#include <cstring>
+#include <unistd.h>
+
+// Сигнатура файла кэша
+static const char CACHE_MAGIC[8] = {'V', 'C', 'C', 'A', 'C', 'H', 'E', '1'};
+
+// Множители для перемешивания битов
+static const uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+static const uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+
+static inline uint64_t RotateLeft(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// Финальное перемешивание, чтобы каждый бит входа влиял на все биты результата
+static inline uint64_t Avalanche(uint64_t value)
+{
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDULL;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+// Функция для вычисления ключа вектора: две независимые 64-битные цепочки
+VectorKey HashVector(const double *values, size_t size, uint64_t seed)
+{
+    uint64_t low = seed ^ (size * PRIME1);
+    uint64_t high = ~seed ^ (size * PRIME2);
+    for (size_t i = 0; i < size; ++i)
+    {
+        uint64_t word;
+        memcpy(&word, values + i, sizeof(word));
+        low = RotateLeft(low ^ (word * PRIME2), 31) * PRIME1;
+        high = RotateLeft(high ^ (word * PRIME4), 27) * PRIME3;
+    }
+    return {Avalanche(low ^ RotateLeft(high, 17)), Avalanche(high + low)};
+}
+
+// Конструктор
+ResultCache::ResultCache(const string &path, const string &tag)
+    : path_(path)
+{
+    vector<double> tag_words((tag.size() + sizeof(double) - 1) / sizeof(double));
+    if (!tag.empty())
+    {
+        memcpy(tag_words.data(), tag.data(), tag.size());
+    }
+    this->seed_ = HashVector(tag_words.data(), tag_words.size(), tag.size()).low;
+}
+
+// Метод для загрузки кэша
+size_t ResultCache::load()
+{
+    ifstream cache_file(this->path_, ios::binary);
+    if (!cache_file.is_open())
+    {
+        return 0;
+    }
+
+    char magic[sizeof(CACHE_MAGIC)];
+    if (!cache_file.read(magic, sizeof(magic)) || memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0)
+    {
+        throw RuntimeError("File \"" + this->path_ + "\" is not a result cache", __func__);
+    }
+
+    size_t loaded = 0;
+    VectorKey key;
+    double result;
+    while (cache_file.read(reinterpret_cast<char *>(&key), sizeof(key)) &&
+           cache_file.read(reinterpret_cast<char *>(&result), sizeof(result)))
+    {
+        this->entries_[key] = result;
+        ++loaded;
+    }
+    cache_file.close();
+
+    // Хвост после последней целой записи отбрасывается, чтобы новые записи шли сразу за ней
+    if (truncate(this->path_.c_str(), sizeof(CACHE_MAGIC) + loaded * (sizeof(key) + sizeof(result))) < 0)
+    {
+        throw RuntimeError("Failed to truncate cache file \"" + this->path_ + "\"", __func__);
+    }
+    return loaded;
+}
+
+// Метод для сохранения новых записей
+void ResultCache::save()
+{
+    if (this->added_.empty())
+    {
+        return;
+    }
+
+    bool exists = ifstream(this->path_).is_open();
+    ofstream cache_file(this->path_, ios::binary | ios::app);
+    if (!cache_file.is_open())
+    {
+        throw RuntimeError("Failed to open cache file \"" + this->path_ + "\"", __func__);
+    }
+
+    if (!exists)
+    {
+        cache_file.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    }
+    for (const auto &entry : this->added_)
+    {
+        cache_file.write(reinterpret_cast<const char *>(&entry.first), sizeof(entry.first));
+        cache_file.write(reinterpret_cast<const char *>(&entry.second), sizeof(entry.second));
+    }
+    if (!cache_file)
+    {
+        throw RuntimeError("Failed to write cache file \"" + this->path_ + "\"", __func__);
+    }
+    this->added_.clear();
+}
+
+VectorKey ResultCache::key(VectorSpan<double> values) const
+{
+    return HashVector(values.data(), values.size(), this->seed_);
+}
+
+bool ResultCache::find(const VectorKey &key, double &result) const
+{
+    auto it = this->entries_.find(key);
+    if (it == this->entries_.end())
+    {
+        return false;
+    }
+    result = it->second;
+    return true;
+}
+
+void ResultCache::insert(const VectorKey &key, double result)
+{
+    if (this->entries_.insert(make_pair(key, result)).second)
+    {
+        this->added_.push_back(make_pair(key, result));
+    }
+}
+
+size_t ResultCache::size() const
+{
+    return this->entries_.size();
+}
+
+// Функция для вычислений с использованием кэша
+vector<double> CalculateCached(ResultCache &cache, const VectorBatch &data,
+                               const function<vector<double>(const VectorBatch &)> &calculate,
+                               size_t &hits)
+{
+    vector<double> results(data.size());
+    vector<VectorKey> miss_keys;
+    vector<size_t> miss_positions;
+    VectorBatch misses;
+
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        VectorKey key = cache.key(data[i]);
+        if (!cache.find(key, results[i]))
+        {
+            miss_keys.push_back(key);
+            miss_positions.push_back(i);
+            misses.push_back(data[i]);
+        }
+    }
+    hits = data.size() - misses.size();
+
+    if (!misses.empty())
+    {
+        vector<double> miss_results = calculate(misses);
+        for (size_t i = 0; i < miss_results.size(); ++i)
+        {
+            results[miss_positions[i]] = miss_results[i];
+            cache.insert(miss_keys[i], miss_results[i]);
+        }
+    }
+    return results;
+}
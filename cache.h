@@ -0,0 +1,153 @@
+#pragma once
+
+#include "error.h"
+#include "data.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+using namespace std;
+
+/**
+ * @struct VectorKey
+ * @brief 128-битный ключ содержимого вектора.
+ */
+struct VectorKey
+{
+    uint64_t low;  ///< Младшие 64 бита.
+    uint64_t high; ///< Старшие 64 бита.
+
+    /**
+     * @brief Сравнивает ключи.
+     * 
+     * @param other Другой ключ.
+     * @return true, если ключи равны.
+     */
+    bool operator==(const VectorKey &other) const
+    {
+        return low == other.low && high == other.high;
+    }
+};
+
+/**
+ * @struct VectorKeyHash
+ * @brief Хеш-функция ключа для unordered_map.
+ */
+struct VectorKeyHash
+{
+    /**
+     * @brief Возвращает хеш ключа.
+     * 
+     * @param key Ключ.
+     * @return Хеш ключа.
+     */
+    size_t operator()(const VectorKey &key) const
+    {
+        return key.low;
+    }
+};
+
+/**
+ * @brief Вычисляет ключ вектора по байтам его элементов.
+ * 
+ * @param values Указатель на элементы вектора.
+ * @param size Количество элементов.
+ * @param seed Начальное значение, разделяющее ключи разных конфигураций.
+ * @return Ключ вектора.
+ */
+VectorKey HashVector(const double *values, size_t size, uint64_t seed = 0);
+
+/**
+ * @class ResultCache
+ * @brief Класс постоянного кэша результатов, адресуемого содержимым векторов.
+ *
+ * Хранит результаты по ключу содержимого вектора в файле, дописываемом
+ * после каждого запуска. Конфигурация сервера (тип данных, хеш и т.п.)
+ * задаётся меткой и участвует в вычислении ключа, поэтому результаты
+ * разных конфигураций в одном файле не смешиваются.
+ */
+class ResultCache
+{
+public:
+    /**
+     * @brief Конструктор класса ResultCache.
+     * 
+     * @param path Путь к файлу кэша.
+     * @param tag Метка конфигурации сервера.
+     */
+    ResultCache(const string &path, const string &tag);
+
+    /**
+     * @brief Загружает записи из файла кэша, если он существует.
+     * 
+     * Неполная последняя запись (например, после аварийного завершения) отбрасывается
+     * и обрезается в файле, чтобы save() дописывал записи сразу за последней целой.
+     * 
+     * @return Количество загруженных записей.
+     * @throws RuntimeError Если файл не является файлом кэша.
+     */
+    size_t load();
+
+    /**
+     * @brief Дописывает новые записи в файл кэша.
+     * 
+     * @throws RuntimeError Если не удалось открыть файл или записать данные.
+     */
+    void save();
+
+    /**
+     * @brief Вычисляет ключ вектора с учётом метки конфигурации.
+     * 
+     * @param values Вектор.
+     * @return Ключ вектора.
+     */
+    VectorKey key(VectorSpan<double> values) const;
+
+    /**
+     * @brief Ищет результат по ключу.
+     * 
+     * @param key Ключ вектора.
+     * @param result Найденный результат.
+     * @return true, если результат найден.
+     */
+    bool find(const VectorKey &key, double &result) const;
+
+    /**
+     * @brief Добавляет результат.
+     * 
+     * @param key Ключ вектора.
+     * @param result Результат.
+     */
+    void insert(const VectorKey &key, double result);
+
+    /**
+     * @brief Возвращает количество записей в кэше.
+     * 
+     * @return Количество записей.
+     */
+    size_t size() const;
+
+private:
+    string path_;                                             ///< Путь к файлу кэша.
+    uint64_t seed_;                                           ///< Начальное значение ключей, полученное из метки.
+    unordered_map<VectorKey, double, VectorKeyHash> entries_; ///< Записи кэша.
+    vector<pair<VectorKey, double>> added_;                   ///< Записи, ещё не сохранённые в файл.
+};
+
+/**
+ * @brief Выполняет вычисления, отправляя только векторы, отсутствующие в кэше.
+ * 
+ * Результаты найденных векторов берутся из кэша, остальные векторы передаются
+ * в calculate, а их результаты добавляются в кэш и расставляются по исходным позициям.
+ * 
+ * @param cache Кэш результатов.
+ * @param data Данные для вычислений в виде вектора векторов.
+ * @param calculate Функция вычисления результатов.
+ * @param hits Количество векторов, найденных в кэше.
+ * @return Результаты вычислений в исходном порядке векторов.
+ */
+vector<double> CalculateCached(ResultCache &cache, const VectorBatch &data,
+                               const function<vector<double>(const VectorBatch &)> &calculate,
+                               size_t &hits);
@@ -0,0 +1,260 @@
+#include "checkpoint.h"
+#include "cache.h"
+#include "logger.h"
+#include <cstring>
+#include <cstdio>
+#include <thread>
+#include <chrono>
+#include <unistd.h>
+
+// Сигнатура файла контрольной точки
+static const char CHECKPOINT_MAGIC[8] = {'V', 'C', 'C', 'K', 'P', 'T', '0', '2'};
+
+// Сигнатура прежней версии без отпечатка входных данных
+static const char CHECKPOINT_MAGIC_V1[8] = {'V', 'C', 'C', 'K', 'P', 'T', '0', '1'};
+
+// Пауза перед первой повторной попыткой и её предел
+static const long RETRY_DELAY_MS = 100;
+static const long RETRY_DELAY_MAX_MS = 5000;
+
+// Функция для вычисления отпечатка входных данных по ключам всех векторов
+static VectorKey FingerprintData(const VectorBatch &data)
+{
+    const size_t words = sizeof(VectorKey) / sizeof(double);
+    vector<double> keys(data.size() * words);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        VectorSpan<double> vec = data[i];
+        VectorKey key = HashVector(vec.data(), vec.size(), i);
+        memcpy(keys.data() + i * words, &key, sizeof(key));
+    }
+    return HashVector(keys.data(), keys.size(), data.elementCount());
+}
+
+// Конструктор
+Checkpoint::Checkpoint(const string &path, const VectorBatch &data)
+    : path_(path), vectors_(data.size()), elements_(data.elementCount()), fingerprint_(FingerprintData(data)),
+      results_(data.size()), done_(data.size(), false), completed_(0), valid_(false) {}
+
+// Метод для загрузки контрольной точки
+size_t Checkpoint::load()
+{
+    ifstream checkpoint_file(this->path_, ios::binary);
+    if (!checkpoint_file.is_open())
+    {
+        return 0;
+    }
+
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    uint64_t header[4];
+    if (!checkpoint_file.read(magic, sizeof(magic)))
+    {
+        // Файл оборвался на заголовке: начинаем заново
+        return 0;
+    }
+    const bool stale = memcmp(magic, CHECKPOINT_MAGIC_V1, sizeof(magic)) == 0;
+    if (!stale && memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0)
+    {
+        throw RuntimeError("File \"" + this->path_ + "\" is not a checkpoint", __func__);
+    }
+    if (stale || !checkpoint_file.read(reinterpret_cast<char *>(header), sizeof(header)))
+    {
+        // Заголовок оборван или не содержит отпечатка: начинаем заново
+        return 0;
+    }
+    if (header[0] != this->vectors_ || header[1] != this->elements_ ||
+        header[2] != this->fingerprint_.low || header[3] != this->fingerprint_.high)
+    {
+        // Контрольная точка другого входного файла: её результаты не применяются
+        LogInfo() << "Checkpoint " << this->path_ << " was made for different input data, starting over";
+        checkpoint_file.close();
+        if (truncate(this->path_.c_str(), 0) < 0)
+        {
+            throw RuntimeError("Failed to truncate checkpoint \"" + this->path_ + "\"", __func__);
+        }
+        return 0;
+    }
+    this->valid_ = true;
+
+    // Записи читаются до первой неполной или повреждённой
+    streamoff valid_size = checkpoint_file.tellg();
+    uint64_t range[2];
+    vector<double> results;
+    VectorKey check;
+    while (checkpoint_file.read(reinterpret_cast<char *>(range), sizeof(range)))
+    {
+        if (range[1] == 0 || range[0] > this->vectors_ || range[1] > this->vectors_ - range[0])
+        {
+            break;
+        }
+        results.resize(range[1]);
+        if (!checkpoint_file.read(reinterpret_cast<char *>(results.data()), results.size() * sizeof(double)) ||
+            !checkpoint_file.read(reinterpret_cast<char *>(&check), sizeof(check)) ||
+            !(check == HashVector(results.data(), results.size(), range[0])))
+        {
+            break;
+        }
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            this->results_[range[0] + i] = results[i];
+            if (!this->done_[range[0] + i])
+            {
+                this->done_[range[0] + i] = true;
+                ++this->completed_;
+            }
+        }
+        valid_size = checkpoint_file.tellg();
+    }
+    checkpoint_file.close();
+
+    // Хвост после последней целой записи отбрасывается, чтобы новые записи шли сразу за ней
+    if (truncate(this->path_.c_str(), valid_size) < 0)
+    {
+        throw RuntimeError("Failed to truncate checkpoint \"" + this->path_ + "\"", __func__);
+    }
+    return this->completed_;
+}
+
+// Метод для сохранения завершённого диапазона
+void Checkpoint::record(size_t begin, const vector<double> &results)
+{
+    if (results.empty())
+    {
+        return;
+    }
+    if (!this->file_.is_open())
+    {
+        this->file_.open(this->path_, ios::binary | (this->valid_ ? ios::app : ios::trunc));
+        if (!this->file_.is_open())
+        {
+            throw RuntimeError("Failed to open checkpoint \"" + this->path_ + "\"", __func__);
+        }
+        if (!this->valid_)
+        {
+            uint64_t header[4] = {this->vectors_, this->elements_, this->fingerprint_.low, this->fingerprint_.high};
+            this->file_.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+            this->file_.write(reinterpret_cast<const char *>(header), sizeof(header));
+            this->valid_ = true;
+        }
+    }
+
+    uint64_t range[2] = {begin, results.size()};
+    VectorKey check = HashVector(results.data(), results.size(), begin);
+    this->file_.write(reinterpret_cast<const char *>(range), sizeof(range));
+    this->file_.write(reinterpret_cast<const char *>(results.data()), results.size() * sizeof(double));
+    this->file_.write(reinterpret_cast<const char *>(&check), sizeof(check));
+
+    // Запись сразу передаётся ядру, чтобы пережить аварийное завершение процесса
+    this->file_.flush();
+    if (!this->file_)
+    {
+        throw RuntimeError("Failed to write checkpoint \"" + this->path_ + "\"", __func__);
+    }
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        this->results_[begin + i] = results[i];
+        if (!this->done_[begin + i])
+        {
+            this->done_[begin + i] = true;
+            ++this->completed_;
+        }
+    }
+}
+
+// Метод для получения незавершённых диапазонов
+vector<pair<size_t, size_t>> Checkpoint::pending(size_t chunk_size) const
+{
+    chunk_size = max<size_t>(chunk_size, 1);
+    vector<pair<size_t, size_t>> ranges;
+    size_t i = 0;
+    while (i < this->done_.size())
+    {
+        if (this->done_[i])
+        {
+            ++i;
+            continue;
+        }
+        size_t end = i;
+        while (end < this->done_.size() && end - i < chunk_size && !this->done_[end])
+        {
+            ++end;
+        }
+        ranges.push_back(make_pair(i, end));
+        i = end;
+    }
+    return ranges;
+}
+
+size_t Checkpoint::getCompleted() const
+{
+    return this->completed_;
+}
+
+const vector<double> &Checkpoint::getResults() const
+{
+    return this->results_;
+}
+
+// Метод для удаления файла контрольной точки
+void Checkpoint::remove()
+{
+    if (this->file_.is_open())
+    {
+        this->file_.close();
+    }
+    ::remove(this->path_.c_str());
+    this->valid_ = false;
+}
+
+// Функция для вычислений с продолжением после обрыва связи
+vector<double> CalculateResumable(Client &client, const VectorBatch &data, Checkpoint &checkpoint,
+                                  size_t chunk_size, size_t retries)
+{
+    for (const auto &range : checkpoint.pending(chunk_size))
+    {
+        vector<double> results;
+        for (size_t failures = 0;; ++failures)
+        {
+            try
+            {
+                if (!client.isConnected())
+                {
+                    client.reconnect();
+                }
+                results = client.submit(data, range.first, range.second);
+                break;
+            }
+            catch (const RuntimeError &e)
+            {
+                // Состояние сессии неизвестно: часть повторяется в новом соединении
+                client.closeConnection();
+                Metrics::instance().count(Counter::Errors);
+                // По истечении срока запуска ошибка сообщается как таймаут, независимо от её причины
+                const Deadline &deadline = client.getJobDeadline();
+                if (deadline.expired())
+                {
+                    throw TimeoutError("Job deadline expired while retrying vectors " + to_string(range.first) + ".." +
+                                           to_string(range.second) + ": " + e.what(),
+                                       __func__);
+                }
+                if (failures >= retries)
+                {
+                    throw;
+                }
+                // Пауза перед повтором не выходит за срок запуска
+                long delay = min(RETRY_DELAY_MS << min<size_t>(failures, 16), RETRY_DELAY_MAX_MS);
+                if (deadline.remaining() >= 0)
+                {
+                    delay = min<long>(delay, deadline.remaining());
+                }
+                LogInfo() << "Request for vectors " << range.first << ".." << range.second << " failed: " << e.what()
+                          << "; reconnecting in " << delay << " ms (attempt " << failures + 1 << " of " << retries << ")";
+                this_thread::sleep_for(chrono::milliseconds(delay));
+            }
+        }
+        checkpoint.record(range.first, results);
+    }
+    return checkpoint.getResults();
+}
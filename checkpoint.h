@@ -0,0 +1,111 @@
+#pragma once
+
+#include "error.h"
+#include "data.h"
+#include "client.h"
+#include "cache.h"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @class Checkpoint
+ * @brief Класс файла контрольной точки длительного вычисления.
+ *
+ * Файл лежит рядом с выходным файлом и дописывается после каждой завершённой
+ * части: в нём хранятся диапазоны векторов вместе с их результатами. Заголовок
+ * содержит количество векторов и элементов входных данных и отпечаток их
+ * содержимого, чтобы контрольная точка не была применена к другому входному файлу.
+ */
+class Checkpoint
+{
+public:
+    /**
+     * @brief Конструктор класса Checkpoint.
+     * 
+     * @param path Путь к файлу контрольной точки.
+     * @param data Входные данные, для которых ведётся контрольная точка.
+     */
+    Checkpoint(const string &path, const VectorBatch &data);
+
+    /**
+     * @brief Загружает завершённые диапазоны из файла, если он существует.
+     * 
+     * Неполная или повреждённая последняя запись (например, после аварийного
+     * завершения) отбрасывается и будет перезаписана. Контрольная точка других
+     * входных данных отбрасывается целиком, и вычисления начинаются заново.
+     * 
+     * @return Количество векторов, результаты которых уже получены.
+     * @throws RuntimeError Если файл не является контрольной точкой.
+     */
+    size_t load();
+
+    /**
+     * @brief Сохраняет результаты завершённого диапазона.
+     * 
+     * @param begin Индекс первого вектора диапазона.
+     * @param results Результаты векторов диапазона.
+     * @throws RuntimeError Если не удалось записать файл.
+     */
+    void record(size_t begin, const vector<double> &results);
+
+    /**
+     * @brief Возвращает диапазоны, результаты которых ещё не получены.
+     * 
+     * @param chunk_size Максимальное количество векторов в одном диапазоне.
+     * @return Список пар [begin, end) в порядке возрастания.
+     */
+    vector<pair<size_t, size_t>> pending(size_t chunk_size) const;
+
+    /**
+     * @brief Возвращает количество векторов, результаты которых уже получены.
+     * 
+     * @return Количество векторов.
+     */
+    size_t getCompleted() const;
+
+    /**
+     * @brief Возвращает результаты всех векторов (незавершённые равны нулю).
+     * 
+     * @return Результаты в исходном порядке векторов.
+     */
+    const vector<double> &getResults() const;
+
+    /**
+     * @brief Удаляет файл контрольной точки после записи выходного файла.
+     */
+    void remove();
+
+private:
+    string path_;            ///< Путь к файлу контрольной точки.
+    uint64_t vectors_;       ///< Количество векторов входных данных.
+    uint64_t elements_;      ///< Общее количество элементов входных данных.
+    VectorKey fingerprint_;  ///< Отпечаток содержимого входных данных.
+    vector<double> results_; ///< Результаты векторов.
+    vector<bool> done_;      ///< Признаки полученных результатов.
+    size_t completed_;       ///< Количество полученных результатов.
+    bool valid_;             ///< Файл существует и содержит корректный заголовок.
+    ofstream file_;          ///< Файл, открытый для дописывания.
+};
+
+/**
+ * @brief Выполняет вычисления частями, продолжая с первой незавершённой части после обрыва связи.
+ * 
+ * Результаты каждой части сохраняются в контрольной точке. Если запрос не удался,
+ * клиент переподключается, повторно аутентифицируется и повторяет ту же часть,
+ * делая между попытками паузу, растущую вдвое. После истечения срока задания
+ * попытки не повторяются.
+ * 
+ * @param client Аутентифицированный клиент.
+ * @param data Данные для вычислений в виде вектора векторов.
+ * @param checkpoint Загруженная контрольная точка для этих данных.
+ * @param chunk_size Количество векторов в одном запросе.
+ * @param retries Количество попыток переподключения подряд для одной части.
+ * @return Результаты вычислений в исходном порядке векторов.
+ * @throws RuntimeError Если часть не удалось вычислить после всех попыток.
+ */
+vector<double> CalculateResumable(Client &client, const VectorBatch &data, Checkpoint &checkpoint,
+                                  size_t chunk_size, size_t retries);
@@ -1,13 +1,28 @@
 #include "client.h"
 
+// Размер кольца io_uring: одна запись всегда остаётся под приём результатов
+static const unsigned RING_ENTRIES = 64;
+
+// Метка операции приёма результатов в кольце
+static const uint64_t RECV_TAG = UINT64_MAX;
+
+// Функция для проверки, что неблокирующий вызов нужно повторить после ожидания
+static bool WouldBlock(int error)
+{
+    return error == EAGAIN || error == EWOULDBLOCK || error == EINPROGRESS;
+}
+
 // Конструктор
 Client::Client(const string &address, uint16_t port)
-    : address_(address), port_(port), socket_(-1) {}
+    : address_(address), port_(port), socket_(-1), batch_limit_(IOV_MAX),
+      completed_(0), reconnects_(0), io_backend_(IoBackend::Blocking) {}
 
 // Метод для установки соединения
 void Client::connectToServer()
 {
-    this->socket_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    PhaseTimer timer("connect");
+    beginPhase();
+    this->socket_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
     if (this->socket_ < 0)
     {
         throw RuntimeError("Failed to create socket", __func__);
@@ -18,42 +33,88 @@ void Client::connectToServer()
     server_addr.sin_family = AF_INET;
     server_addr.sin_port = htons(this->port_);
 
-    if (inet_pton(AF_INET, this->address_.c_str(), &server_addr.sin_addr) <= 0)
+    // Незавершённое подключение закрывается, чтобы isConnected() не считал его установленным
+    try
     {
-        throw RuntimeError("Invalid address/ Address not supported", __func__);
-    }
+        if (inet_pton(AF_INET, this->address_.c_str(), &server_addr.sin_addr) <= 0)
+        {
+            throw RuntimeError("Invalid address/ Address not supported", __func__);
+        }
+        applySocketOptions();
 
-    if (connect(this->socket_, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0)
+        // Неблокирующее подключение ожидается не дольше срока фазы
+        Metrics::instance().count(Counter::Connects);
+        if (connect(this->socket_, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0)
+        {
+            if (errno != EINPROGRESS)
+            {
+                throw RuntimeError("Connection failed", __func__);
+            }
+            WaitSocket(this->socket_, POLLOUT, this->phase_deadline_, "connect");
+            int error = 0;
+            socklen_t length = sizeof(error);
+            if (getsockopt(this->socket_, SOL_SOCKET, SO_ERROR, &error, &length) < 0 || error != 0)
+            {
+                throw RuntimeError("Connection failed", __func__);
+            }
+        }
+    }
+    catch (...)
     {
-        throw RuntimeError("Connection failed", __func__);
+        closeConnection();
+        throw;
     }
+    this->reader_.reset(this->socket_);
+    this->completed_ = 0;
 }
 
 // Метод для аутентификации
 void Client::authenticate(const string &username, const string &password)
 {
+    PhaseTimer timer("authenticate");
+    beginPhase();
+
     // Отправка логина серверу
-    if (send(this->socket_, username.c_str(), username.size(), 0) < 0)
-    {
-        throw RuntimeError("Failed to send login", __func__);
-    }
+    struct iovec login = {const_cast<char *>(username.data()), username.size()};
+    sendIov(&login, 1, "login");
 
     // Получение соли от сервера
+    armQuickAck();
     char salt[17]; // Соль должна быть 16 символов
-    int salt_length = recv(this->socket_, salt, sizeof(salt) - 1, 0);
-    if (salt_length < 0)
+    this->reader_.readExact(salt, sizeof(salt) - 1, "salt", this->phase_deadline_);
+    salt[sizeof(salt) - 1] = '\0';
+
+    // Вычисление хеша
+    string hash_hex = digest(salt, password);
+
+    // Отправка хеша серверу
+    struct iovec hash = {const_cast<char *>(hash_hex.data()), hash_hex.size()};
+    sendIov(&hash, 1, "hash");
+
+    // Получение ответа от сервера
+    armQuickAck();
+    char response[3];
+    this->reader_.readExact(response, sizeof(response) - 1, "auth response", this->phase_deadline_);
+    response[sizeof(response) - 1] = '\0';
+    if (string(response) != "OK")
     {
-        throw RuntimeError("Failed to receive salt", __func__);
+        throw RuntimeError("Authentication failed", __func__);
     }
-    salt[salt_length] = '\0';
 
+    this->username_ = username;
+    this->password_ = password;
+}
+
+// Метод для вычисления хеша пароля
+string Client::digest(const string &salt, const string &password)
+{
     // Вычисление хеша с использованием CryptoPP
     Weak::MD5 hash_func; // создаем объект хеш-функции
     string hash_hex;
 
     // формирование хэша и преобразование в шестнадцатеричную строку
     StringSource(
-        string(salt) + password,
+        salt + password,
         true,
         new HashFilter(
             hash_func,
@@ -62,76 +123,554 @@ void Client::authenticate(const string &username, const string &password)
                 true // Заглавные буквы
                 )));
 
-    // Отправка хеша серверу
-    if (send(this->socket_, hash_hex.c_str(), hash_hex.size(), 0) < 0)
+    return hash_hex;
+}
+
+// Метод для переподключения
+void Client::reconnect()
+{
+    if (this->username_.empty())
     {
-        throw RuntimeError("Failed to send hash", __func__);
+        throw RuntimeError("Cannot reconnect before successful authentication", __func__);
     }
 
-    // Получение ответа от сервера
-    char response[1024];
-    int response_length = recv(this->socket_, response, sizeof(response) - 1, 0);
-    if (response_length < 0)
+    closeConnection();
+    connectToServer();
+    authenticate(this->username_, this->password_);
+    ++this->reconnects_;
+}
+
+bool Client::isConnected() const
+{
+    return this->socket_ >= 0;
+}
+
+size_t Client::getReconnects() const
+{
+    return this->reconnects_;
+}
+
+// Метод для выполнения одного запроса
+template <typename T>
+vector<T> Client::submit(const BasicVectorBatch<T> &data, size_t begin, size_t end)
+{
+    const uint32_t count = end - begin;
+    for (int attempt = 0;; ++attempt)
     {
-        throw RuntimeError("Failed to receive auth response", __func__);
+        const bool reused = this->completed_ > 0;
+        beginPhase();
+        try
+        {
+            vector<T> results;
+            // Кольцо используется, только если в буфере чтения не осталось данных от прошлых ответов,
+            // а ожидания не ограничены сроком: операции кольца ждут готовности сокета сами
+            if (this->io_backend_ == IoBackend::Uring && !this->phase_deadline_.isSet() && this->reader_.buffered() == 0)
+            {
+                results = exchange(data, begin, end);
+            }
+            else
+            {
+                sendCount(count);
+                sendVectors(data, begin, end);
+                results = receiveResults<T>(count);
+            }
+            ++this->completed_;
+            return results;
+        }
+        catch (const TimeoutError &)
+        {
+            // Зависший сервер не повторяет запрос в пределах фазы
+            throw;
+        }
+        catch (const RuntimeError &)
+        {
+            // Сервер мог закрыть соединение после предыдущего запроса
+            if (attempt > 0 || !reused)
+            {
+                throw;
+            }
+            reconnect();
+        }
     }
+}
 
-    response[response_length] = '\0';
-    if (string(response) != "OK")
+vector<double> Client::calculate(const VectorBatch &data)
+{
+    // Передача векторов и получение результатов
+    vector<double> results = submit(data, 0, data.size());
+
+    // Логирование результата (форматируется, только если включён уровень debug)
+    if (Logger::instance().enabled(LogLevel::Debug))
     {
-        throw RuntimeError("Authentication failed", __func__);
+        LogDebug() << "Client.calculate() results: " << FormatVector(results, Logger::instance().getDumpLimit());
+    }
+
+    return results;
+}
+
+// Метод для вычислений с несколькими запросами в полёте
+vector<double> Client::calculateWindowed(const VectorBatch &data, size_t chunk_size, size_t window)
+{
+    chunk_size = max<size_t>(chunk_size, 1);
+    window = max<size_t>(window, 1);
+    const size_t requests = (data.size() + chunk_size - 1) / chunk_size;
+    vector<double> results(data.size());
+    beginPhase();
+
+    // Отправитель опережает получателя не более чем на window запросов
+    mutex window_mutex;
+    condition_variable window_changed;
+    size_t received = 0;
+    bool cancelled = false;
+    exception_ptr sender_error;
+
+    thread sender([&]() {
+        try
+        {
+            for (size_t request = 0; request < requests; ++request)
+            {
+                {
+                    unique_lock<mutex> lock(window_mutex);
+                    window_changed.wait(lock, [&]() { return cancelled || request - received < window; });
+                    if (cancelled)
+                    {
+                        return;
+                    }
+                }
+                const size_t begin = request * chunk_size;
+                const size_t end = min(data.size(), begin + chunk_size);
+                sendCount(end - begin);
+                sendVectors(data, begin, end);
+            }
+        }
+        catch (...)
+        {
+            sender_error = current_exception();
+            interrupt();
+        }
+    });
+
+    // Ответы приходят в порядке запросов, поэтому сопоставляются по номеру
+    exception_ptr receiver_error;
+    try
+    {
+        for (size_t request = 0; request < requests; ++request)
+        {
+            const size_t begin = request * chunk_size;
+            const size_t end = min(data.size(), begin + chunk_size);
+            vector<double> part = receiveResults(end - begin);
+            copy(part.begin(), part.end(), results.begin() + begin);
+
+            lock_guard<mutex> lock(window_mutex);
+            ++received;
+            window_changed.notify_all();
+        }
+    }
+    catch (...)
+    {
+        receiver_error = current_exception();
+        interrupt();
+        lock_guard<mutex> lock(window_mutex);
+        cancelled = true;
+        window_changed.notify_all();
     }
+    sender.join();
+
+    // Первопричиной считается ошибка отправки
+    if (sender_error)
+    {
+        rethrow_exception(sender_error);
+    }
+    if (receiver_error)
+    {
+        rethrow_exception(receiver_error);
+    }
+    this->completed_ += requests;
+
+    if (Logger::instance().enabled(LogLevel::Debug))
+    {
+        LogDebug() << "Client.calculateWindowed() results: " << FormatVector(results, Logger::instance().getDumpLimit());
+    }
+    return results;
 }
 
-vector<double> Client::calculate(const vector<vector<double>> &data)
+// Метод для вычислений с передачей файла через sendfile()
+vector<double> Client::calculateFile(const string &path, uint32_t num_vectors)
 {
-    // Передача количества векторов
-    uint32_t num_vectors = data.size();
-    if (send(this->socket_, &num_vectors, sizeof(num_vectors), 0) < 0)
+    int file_fd = ::open(path.c_str(), O_RDONLY);
+    if (file_fd < 0)
+    {
+        throw RuntimeError("Failed to open input file \"" + path + "\"", __func__);
+    }
+
+    struct stat file_stat;
+    if (fstat(file_fd, &file_stat) < 0)
     {
-        throw RuntimeError("Failed to send number of vectors", __func__);
+        ::close(file_fd);
+        throw RuntimeError("Failed to stat input file \"" + path + "\"", __func__);
     }
 
-    // Передача каждого вектора
-    for (const auto &vec : data)
+    // Передача файла целиком с учётом частичной отправки
+    PhaseTimer timer("send");
+    beginPhase();
+    off_t offset = 0;
+    while (offset < file_stat.st_size)
     {
-        uint32_t vec_size = vec.size();
-        if (send(this->socket_, &vec_size, sizeof(vec_size), 0) < 0)
+        Metrics::instance().count(Counter::SendCalls);
+        ssize_t sent = sendfile(this->socket_, file_fd, &offset, file_stat.st_size - offset);
+        if (sent < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (sent < 0 && WouldBlock(errno))
         {
-            throw RuntimeError("Failed to send vector size", __func__);
+            try
+            {
+                WaitSocket(this->socket_, POLLOUT, this->phase_deadline_, "send input file");
+            }
+            catch (const RuntimeError &)
+            {
+                ::close(file_fd);
+                throw;
+            }
+            continue;
         }
-        if (send(this->socket_, vec.data(), vec_size * sizeof(double), 0) < 0)
+        if (sent <= 0)
         {
-            throw RuntimeError("Failed to send vector data", __func__);
+            ::close(file_fd);
+            throw RuntimeError("Failed to send input file", __func__);
         }
+        Metrics::instance().count(Counter::BytesSent, sent);
     }
+    ::close(file_fd);
+
+    return receiveResults(num_vectors);
+}
+
+// Метод для передачи количества векторов
+void Client::sendCount(uint32_t num_vectors)
+{
+    struct iovec iov = {&num_vectors, sizeof(num_vectors)};
+    sendIov(&iov, 1, "number of vectors");
+}
+
+// Метод для передачи векторов пакетами фрагментов
+template <typename T>
+void Client::sendVectors(const BasicVectorBatch<T> &data)
+{
+    sendVectors(data, 0, data.size());
+}
+
+template <typename T>
+void Client::sendVectors(const BasicVectorBatch<T> &data, size_t begin, size_t end)
+{
+    PhaseTimer timer("send");
 
-    // Получение результатов
-    vector<double> results(num_vectors);
-    for (uint32_t i = 0; i < num_vectors; ++i)
+    // Размеры векторов должны жить до отправки пакета, поэтому память под них резервируется заранее
+    vector<uint32_t> sizes;
+    sizes.reserve(this->batch_limit_);
+    vector<struct iovec> iov;
+    iov.reserve(this->batch_limit_);
+
+    size_t next = begin;
+    while (next < end)
     {
-        if (recv(this->socket_, &results[i], sizeof(double), 0) < 0)
+        sizes.clear();
+        iov.clear();
+        while (next < end && iov.size() + 2 <= this->batch_limit_)
         {
-            throw RuntimeError("Failed to receive result", __func__);
+            VectorSpan<T> vec = data[next++];
+            sizes.push_back(vec.size());
+            iov.push_back({&sizes.back(), sizeof(uint32_t)});
+            if (!vec.empty())
+            {
+                iov.push_back({const_cast<T *>(vec.data()), vec.size() * sizeof(T)});
+            }
         }
+        sendIov(iov.data(), iov.size(), "vectors");
     }
+}
 
-    // Логирование результата
-    cout << "Log: \"Client.calculate()\"\n";
-    cout << "Results: {";
-    for (const auto &val : results)
+// Метод для передачи набора фрагментов
+void Client::sendIov(struct iovec *iov, size_t count, const string &what)
+{
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+
+    while (count > 0)
     {
-        cout << val << ", ";
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+        ssize_t sent = sendmsg(this->socket_, &msg, MSG_NOSIGNAL);
+        Metrics::instance().count(Counter::SendCalls);
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (WouldBlock(errno))
+            {
+                WaitSocket(this->socket_, POLLOUT, this->phase_deadline_, "send " + what);
+                continue;
+            }
+            throw RuntimeError("Failed to send " + what, __func__);
+        }
+        Metrics::instance().count(Counter::BytesSent, sent);
+
+        // Пропуск полностью отправленных фрагментов и сдвиг частично отправленного
+        size_t remaining = sent;
+        while (count > 0 && remaining >= iov->iov_len)
+        {
+            remaining -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0)
+        {
+            iov->iov_base = static_cast<char *>(iov->iov_base) + remaining;
+            iov->iov_len -= remaining;
+        }
     }
-    if (!results.empty())
+}
+
+// Метод для выполнения запроса через io_uring
+template <typename T>
+vector<T> Client::exchange(const BasicVectorBatch<T> &data, size_t begin, size_t end)
+{
+    PhaseTimer timer("exchange");
+
+    // Количество векторов, затем размер и значения каждого вектора
+    vector<uint32_t> sizes;
+    sizes.reserve(end - begin + 1);
+    vector<struct iovec> iov;
+    iov.reserve(2 * (end - begin) + 1);
+    sizes.push_back(end - begin);
+    iov.push_back({&sizes.back(), sizeof(uint32_t)});
+    for (size_t i = begin; i < end; ++i)
     {
-        cout << "\b\b"; // Удалить последнюю запятую и пробел
+        VectorSpan<T> vec = data[i];
+        sizes.push_back(vec.size());
+        iov.push_back({&sizes.back(), sizeof(uint32_t)});
+        if (!vec.empty())
+        {
+            iov.push_back({const_cast<T *>(vec.data()), vec.size() * sizeof(T)});
+        }
+    }
+
+    vector<T> results(end - begin);
+    exchangeRing(iov, results.data(), results.size() * sizeof(T));
+    return results;
+}
+
+// Функция для сдвига сообщения на отправленные байты
+static void AdvanceMessage(struct msghdr &msg, size_t sent)
+{
+    while (msg.msg_iovlen > 0 && sent >= msg.msg_iov->iov_len)
+    {
+        sent -= msg.msg_iov->iov_len;
+        ++msg.msg_iov;
+        --msg.msg_iovlen;
+    }
+    if (msg.msg_iovlen > 0)
+    {
+        msg.msg_iov->iov_base = static_cast<char *>(msg.msg_iov->iov_base) + sent;
+        msg.msg_iov->iov_len -= sent;
+    }
+}
+
+// Класс для временного перевода сокета в блокирующий режим
+class BlockingScope
+{
+public:
+    explicit BlockingScope(int socket)
+        : socket_(socket), flags_(fcntl(socket, F_GETFL, 0))
+    {
+        fcntl(this->socket_, F_SETFL, this->flags_ & ~O_NONBLOCK);
+    }
+
+    ~BlockingScope()
+    {
+        fcntl(this->socket_, F_SETFL, this->flags_);
+    }
+
+private:
+    int socket_; ///< Сокет.
+    int flags_;  ///< Исходные флаги сокета.
+};
+
+// Метод для передачи запроса и приёма ответа через io_uring
+void Client::exchangeRing(vector<struct iovec> &iov, void *results, size_t result_size)
+{
+    if (!this->ring_)
+    {
+        this->ring_.reset(new IoRing(RING_ENTRIES));
+    }
+    IoRing &ring = *this->ring_;
+
+    // Операции кольца над неблокирующим сокетом на старых ядрах завершаются с EAGAIN
+    BlockingScope blocking(this->socket_);
+
+    // Фрагменты делятся на сообщения не длиннее batch_limit_
+    vector<struct msghdr> messages((iov.size() + this->batch_limit_ - 1) / this->batch_limit_);
+    for (size_t k = 0; k < messages.size(); ++k)
+    {
+        memset(&messages[k], 0, sizeof(messages[k]));
+        messages[k].msg_iov = iov.data() + k * this->batch_limit_;
+        messages[k].msg_iovlen = min(this->batch_limit_, iov.size() - k * this->batch_limit_);
     }
-    cout << "}\n";
 
+    armQuickAck();
+    char *out = static_cast<char *>(results);
+    size_t received = 0;
+    bool receiving = false;
+    size_t in_flight = 0;
+    size_t next = 0;
+    string failure;
+
+    while (failure.empty() && (next < messages.size() || received < result_size))
+    {
+        // Приём ставится до отправки, чтобы ответ забирался сразу по мере поступления
+        if (!receiving && received < result_size)
+        {
+            ring.prepareRecv(this->socket_, out + received, result_size - received, MSG_WAITALL, RECV_TAG);
+            receiving = true;
+            ++in_flight;
+        }
+
+        // Отправки раунда сцеплены, поэтому ядро выполняет их строго по порядку
+        const size_t round_end = min<size_t>(messages.size(), next + ring.getCapacity() - 1);
+        for (size_t k = next; k < round_end; ++k)
+        {
+            ring.prepareSendmsg(this->socket_, &messages[k], MSG_NOSIGNAL | MSG_WAITALL, k + 1 < round_end, k);
+            Metrics::instance().count(Counter::SendCalls);
+        }
+        size_t round_left = round_end - next;
+        in_flight += round_left;
+        ring.submit();
+
+        // Ожидание отправок раунда, а если отправлять уже нечего, то приёма
+        bool wait_receive = round_left == 0;
+        while (in_flight > 0 && (round_left > 0 || wait_receive))
+        {
+            IoCompletion completion = ring.wait();
+            --in_flight;
+            if (completion.user_data == RECV_TAG)
+            {
+                receiving = false;
+                wait_receive = false;
+                if (completion.result <= 0)
+                {
+                    failure = completion.result == 0 ? "Connection closed while receiving results" : "Failed to receive results";
+                    break;
+                }
+                Metrics::instance().count(Counter::RecvCalls);
+                Metrics::instance().count(Counter::BytesReceived, completion.result);
+                received += completion.result;
+                continue;
+            }
+
+            // Отменённые после неполной отправки сообщения повторяются в следующем раунде
+            --round_left;
+            if (completion.result == -ECANCELED)
+            {
+                continue;
+            }
+            if (completion.result < 0)
+            {
+                failure = "Failed to send vectors";
+                continue;
+            }
+            Metrics::instance().count(Counter::BytesSent, completion.result);
+            AdvanceMessage(messages[completion.user_data], completion.result);
+        }
+        while (next < messages.size() && messages[next].msg_iovlen == 0)
+        {
+            ++next;
+        }
+    }
+
+    if (!failure.empty())
+    {
+        // Незавершённые операции пишут в буферы запроса, поэтому их нужно дождаться
+        if (in_flight > 0)
+        {
+            shutdown(this->socket_, SHUT_RDWR);
+        }
+        while (in_flight > 0)
+        {
+            ring.wait();
+            --in_flight;
+        }
+        throw RuntimeError(failure, __func__);
+    }
+}
+
+// Метод для получения результатов
+template <typename T>
+vector<T> Client::receiveResults(uint32_t num_vectors)
+{
+    PhaseTimer timer("receive");
+    armQuickAck();
+    vector<T> results(num_vectors);
+    this->reader_.readExact(results.data(), num_vectors * sizeof(T), "results", this->phase_deadline_);
     return results;
 }
 
+// Метод для настройки сокета перед подключением
+void Client::applySocketOptions()
+{
+    // Размеры буферов задаются до connect(), чтобы учитываться при согласовании окна
+    struct Option
+    {
+        bool enabled;
+        int level;
+        int name;
+        int value;
+        const char *title;
+    };
+#ifndef TCP_FASTOPEN_CONNECT
+    const int TCP_FASTOPEN_CONNECT = 30;
+#endif
+    const Option options[] = {
+        {this->options_.nodelay, IPPROTO_TCP, TCP_NODELAY, 1, "TCP_NODELAY"},
+        {this->options_.send_buffer > 0, SOL_SOCKET, SO_SNDBUF, this->options_.send_buffer, "SO_SNDBUF"},
+        {this->options_.recv_buffer > 0, SOL_SOCKET, SO_RCVBUF, this->options_.recv_buffer, "SO_RCVBUF"},
+        {this->options_.fastopen, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, 1, "TCP_FASTOPEN_CONNECT"},
+        {this->options_.busy_poll > 0, SOL_SOCKET, SO_BUSY_POLL, this->options_.busy_poll, "SO_BUSY_POLL"},
+    };
+
+    for (const Option &option : options)
+    {
+        if (option.enabled && setsockopt(this->socket_, option.level, option.name, &option.value, sizeof(option.value)) < 0)
+        {
+            string error = strerror(errno);
+            closeConnection();
+            throw RuntimeError(string("Failed to set ") + option.title + ": " + error, __func__);
+        }
+    }
+}
+
+// Метод для включения немедленных подтверждений
+void Client::armQuickAck()
+{
+    if (this->options_.quickack)
+    {
+        // Ошибка не критична: подтверждение просто будет отложено
+        int value = 1;
+        setsockopt(this->socket_, IPPROTO_TCP, TCP_QUICKACK, &value, sizeof(value));
+    }
+}
+
+// Метод для прерывания передачи
+void Client::interrupt()
+{
+    if (this->socket_ >= 0)
+    {
+        ::shutdown(this->socket_, SHUT_RDWR);
+    }
+}
+
 // Метод для закрытия соединения
 void Client::closeConnection()
 {
@@ -142,7 +681,66 @@ void Client::closeConnection()
     }
 }
 
+// Методы для настройки пакетной передачи
+void Client::setBatchLimit(size_t batch_limit)
+{
+    this->batch_limit_ = max<size_t>(2, min<size_t>(batch_limit, IOV_MAX));
+}
+
+size_t Client::getBatchLimit() const
+{
+    return batch_limit_;
+}
+
+// Методы для выбора способа обмена данными
+void Client::setIoBackend(IoBackend backend)
+{
+    this->io_backend_ = backend == IoBackend::Uring && IoRing::isSupported() ? IoBackend::Uring : IoBackend::Blocking;
+}
+
+IoBackend Client::getIoBackend() const
+{
+    return this->io_backend_;
+}
+
+// Методы для ограничения времени обмена
+void Client::setJobDeadline(const Deadline &deadline)
+{
+    this->job_deadline_ = deadline;
+}
+
+const Deadline &Client::getJobDeadline() const
+{
+    return this->job_deadline_;
+}
+
+void Client::beginPhase()
+{
+    if (this->job_deadline_.expired())
+    {
+        throw TimeoutError("Job deadline expired", __func__);
+    }
+    Deadline phase = this->options_.timeout > 0 ? Deadline(chrono::milliseconds(this->options_.timeout)) : Deadline();
+    this->phase_deadline_ = phase.earliest(this->job_deadline_);
+}
+
+// Методы для настройки сокета
+void Client::setSocketOptions(const SocketOptions &options)
+{
+    this->options_ = options;
+}
+
+const SocketOptions &Client::getSocketOptions() const
+{
+    return this->options_;
+}
+
 // Методы для получения значений атрибутов
+int Client::getSocket() const
+{
+    return socket_;
+}
+
 const string &Client::getAddress() const
 {
     return address_;
@@ -152,3 +750,28 @@ uint16_t Client::getPort() const
 {
     return port_;
 }
+
+// Явные инстанцирования для поддерживаемых типов элементов
+template vector<int16_t> Client::submit<int16_t>(const BasicVectorBatch<int16_t> &, size_t, size_t);
+template vector<int32_t> Client::submit<int32_t>(const BasicVectorBatch<int32_t> &, size_t, size_t);
+template vector<int64_t> Client::submit<int64_t>(const BasicVectorBatch<int64_t> &, size_t, size_t);
+template vector<float> Client::submit<float>(const BasicVectorBatch<float> &, size_t, size_t);
+template vector<double> Client::submit<double>(const BasicVectorBatch<double> &, size_t, size_t);
+
+template void Client::sendVectors<int16_t>(const BasicVectorBatch<int16_t> &);
+template void Client::sendVectors<int32_t>(const BasicVectorBatch<int32_t> &);
+template void Client::sendVectors<int64_t>(const BasicVectorBatch<int64_t> &);
+template void Client::sendVectors<float>(const BasicVectorBatch<float> &);
+template void Client::sendVectors<double>(const BasicVectorBatch<double> &);
+
+template void Client::sendVectors<int16_t>(const BasicVectorBatch<int16_t> &, size_t, size_t);
+template void Client::sendVectors<int32_t>(const BasicVectorBatch<int32_t> &, size_t, size_t);
+template void Client::sendVectors<int64_t>(const BasicVectorBatch<int64_t> &, size_t, size_t);
+template void Client::sendVectors<float>(const BasicVectorBatch<float> &, size_t, size_t);
+template void Client::sendVectors<double>(const BasicVectorBatch<double> &, size_t, size_t);
+
+template vector<int16_t> Client::receiveResults<int16_t>(uint32_t);
+template vector<int32_t> Client::receiveResults<int32_t>(uint32_t);
+template vector<int64_t> Client::receiveResults<int64_t>(uint32_t);
+template vector<float> Client::receiveResults<float>(uint32_t);
+template vector<double> Client::receiveResults<double>(uint32_t);
@@ -2,16 +2,38 @@
 #pragma once
 
 #include "error.h"
+#include "reader.h"
+#include "terminal.h"
+#include "metrics.h"
+#include "logger.h"
+#include "data.h"
+#include "uring.h"
+#include "deadline.h"
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <memory>
 #include <cstring>
+#include <cerrno>
+#include <climits>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 #include <unistd.h>
 #include <iostream>
 
+#include <fcntl.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/sendfile.h>
+#include <poll.h>
 #include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 
 #include <cryptopp/hex.h>
 #include <cryptopp/md5.h>
@@ -27,6 +49,11 @@ using namespace CryptoPP::Weak1;
  *
  * Этот класс предоставляет методы для установки соединения с сервером,
  * аутентификации пользователя, выполнения вычислений и закрытия соединения.
+ *
+ * Сокет работает в неблокирующем режиме, а каждое ожидание выполняется через
+ * poll() не дольше срока текущей фазы: подключения, аутентификации или одного
+ * вычисления. Срок фазы задаётся SocketOptions::timeout и не превышает срока
+ * всего задания. По истечении срока выбрасывается TimeoutError.
  */
 class Client
 {
@@ -55,6 +82,55 @@ public:
      */
     void authenticate(const string &username, const string &password);
 
+    /**
+     * @brief Вычисляет хеш пароля с солью, передаваемый серверу при аутентификации.
+     * 
+     * @param salt Соль, полученная от сервера.
+     * @param password Пароль пользователя.
+     * @return MD5 от соли и пароля в виде шестнадцатеричной строки заглавными буквами.
+     */
+    static string digest(const string &salt, const string &password);
+
+    /**
+     * @brief Переподключается к серверу и повторно аутентифицируется с прежними учётными данными.
+     * 
+     * @throws RuntimeError Если аутентификация ещё не выполнялась или не удалось подключиться.
+     */
+    void reconnect();
+
+    /**
+     * @brief Проверяет, открыто ли соединение с сервером.
+     * 
+     * @return true, если сокет открыт.
+     */
+    bool isConnected() const;
+
+    /**
+     * @brief Возвращает количество выполненных переподключений.
+     * 
+     * @return Количество переподключений.
+     */
+    size_t getReconnects() const;
+
+    /**
+     * @brief Выполняет один запрос для векторов из заданного диапазона без логирования.
+     * 
+     * Если соединение уже использовалось для предыдущего запроса и было закрыто сервером,
+     * клиент переподключается и повторяет запрос один раз.
+     * 
+     * Методы передачи параметризованы типом элементов T, который должен совпадать
+     * с типом, заданным серверу, и явно инстанцированы для int16_t, int32_t,
+     * int64_t, float и double.
+     * 
+     * @param data Векторы.
+     * @param begin Индекс первого вектора запроса.
+     * @param end Индекс, следующий за последним вектором запроса.
+     * @return Результаты вычислений в виде вектора.
+     * @throws RuntimeError Если не удалось выполнить запрос.
+     */
+    template <typename T>
+    vector<T> submit(const BasicVectorBatch<T> &data, size_t begin, size_t end);
+
     /**
      * @brief Выполняет вычисления на сервере.
      * 
@@ -62,13 +138,174 @@ public:
      * @return Результаты вычислений в виде вектора.
      * @throws RuntimeError Если не удалось передать данные или получить результат.
      */
-    vector<double> calculate(const vector<vector<double>> &data);
+    vector<double> calculate(const VectorBatch &data);
+
+    /**
+     * @brief Выполняет вычисления частями, держа несколько запросов в полёте в одной сессии.
+     * 
+     * Отправка идёт в отдельном потоке и опережает получение результатов не более
+     * чем на window запросов, так что задержка сети перекрывается передачей
+     * следующих частей. Сервер отвечает на запросы по порядку, поэтому результаты
+     * сопоставляются с частями по номеру запроса.
+     * 
+     * @param data Данные для вычислений в виде вектора векторов.
+     * @param chunk_size Количество векторов в одном запросе.
+     * @param window Максимальное количество запросов без полученного ответа.
+     * @return Результаты вычислений в исходном порядке векторов.
+     * @throws RuntimeError Если не удалось передать данные или получить результат.
+     */
+    vector<double> calculateWindowed(const VectorBatch &data, size_t chunk_size, size_t window);
+
+    /**
+     * @brief Выполняет вычисления, передавая входной файл серверу без разбора.
+     * 
+     * Формат входного файла совпадает с форматом передачи, поэтому файл целиком
+     * отправляется в сокет через sendfile() и не копируется в пространство пользователя.
+     * Структура файла должна быть предварительно проверена DataHandler::scanData().
+     * 
+     * @param path Путь к входному файлу.
+     * @param num_vectors Количество векторов в файле.
+     * @return Результаты вычислений в виде вектора.
+     * @throws RuntimeError Если не удалось открыть файл, передать данные или получить результат.
+     */
+    vector<double> calculateFile(const string &path, uint32_t num_vectors);
+
+    /**
+     * @brief Передаёт серверу количество векторов запроса.
+     * 
+     * Вместе с sendVectors() и receiveResults() позволяет выполнять вычисления по частям.
+     * 
+     * @param num_vectors Количество векторов.
+     * @throws RuntimeError Если не удалось передать данные.
+     */
+    void sendCount(uint32_t num_vectors);
+
+    /**
+     * @brief Передаёт серверу очередную часть векторов запроса.
+     * 
+     * @param data Векторы для передачи.
+     * @throws RuntimeError Если не удалось передать данные.
+     */
+    template <typename T>
+    void sendVectors(const BasicVectorBatch<T> &data);
+
+    /**
+     * @brief Передаёт серверу векторы из заданного диапазона.
+     * 
+     * @param data Векторы.
+     * @param begin Индекс первого передаваемого вектора.
+     * @param end Индекс, следующий за последним передаваемым вектором.
+     * @throws RuntimeError Если не удалось передать данные.
+     */
+    template <typename T>
+    void sendVectors(const BasicVectorBatch<T> &data, size_t begin, size_t end);
+
+    /**
+     * @brief Получает результаты вычислений от сервера.
+     * 
+     * @param num_vectors Количество ожидаемых результатов.
+     * @return Результаты вычислений в виде вектора.
+     * @throws RuntimeError Если не удалось получить результат.
+     */
+    template <typename T = double>
+    vector<T> receiveResults(uint32_t num_vectors);
+
+    /**
+     * @brief Прерывает передачу в обоих направлениях, не закрывая сокет.
+     * 
+     * Используется для разблокировки потоков, ожидающих send() или recv().
+     */
+    void interrupt();
 
     /**
      * @brief Закрывает соединение с сервером.
      */
     void closeConnection();
 
+    /**
+     * @brief Устанавливает максимальное количество фрагментов в одном вызове sendmsg().
+     * 
+     * Заголовки и данные векторов объединяются в пакеты не более чем из batch_limit фрагментов.
+     * Значение ограничивается снизу двумя фрагментами, а сверху системным пределом IOV_MAX.
+     * 
+     * @param batch_limit Максимальное количество фрагментов в пакете.
+     */
+    void setBatchLimit(size_t batch_limit);
+
+    /**
+     * @brief Возвращает максимальное количество фрагментов в одном вызове sendmsg().
+     * 
+     * @return Максимальное количество фрагментов в пакете.
+     */
+    size_t getBatchLimit() const;
+
+    /**
+     * @brief Устанавливает параметры сокета для следующих подключений.
+     * 
+     * @param options Параметры сокета.
+     */
+    void setSocketOptions(const SocketOptions &options);
+
+    /**
+     * @brief Возвращает параметры сокета.
+     * 
+     * @return Параметры сокета.
+     */
+    const SocketOptions &getSocketOptions() const;
+
+    /**
+     * @brief Выбирает способ обмена данными в submit().
+     * 
+     * С IoBackend::Uring все фрагменты запроса передаются ядру сцепленными
+     * операциями sendmsg() через io_uring, а приём результатов ставится в ту же
+     * очередь заранее, так что весь запрос выполняется за несколько вызовов
+     * io_uring_enter(). Если io_uring недоступен, остаётся блокирующий обмен.
+     * 
+     * @param backend Способ ввода-вывода.
+     */
+    void setIoBackend(IoBackend backend);
+
+    /**
+     * @brief Возвращает способ обмена данными.
+     * 
+     * @return IoBackend::Uring, только если он был выбран и доступен.
+     */
+    IoBackend getIoBackend() const;
+
+    /**
+     * @brief Устанавливает срок завершения всего задания.
+     * 
+     * @param deadline Срок, общий для всех фаз.
+     */
+    void setJobDeadline(const Deadline &deadline);
+
+    /**
+     * @brief Возвращает срок завершения всего задания.
+     * 
+     * @return Срок задания.
+     */
+    const Deadline &getJobDeadline() const;
+
+    /**
+     * @brief Начинает новую фазу обмена и отсчитывает её срок от текущего момента.
+     * 
+     * Вызывается автоматически при подключении, аутентификации и каждом вычислении;
+     * при обмене по частям через sendCount(), sendVectors() и receiveResults()
+     * вызывается вызывающим кодом.
+     * 
+     * @throws TimeoutError Если срок задания уже истёк.
+     */
+    void beginPhase();
+
+    /**
+     * @brief Возвращает дескриптор сокета подключения.
+     * 
+     * Используется для ожидания событий на нескольких соединениях одновременно.
+     * 
+     * @return Дескриптор сокета или -1, если соединение не установлено.
+     */
+    int getSocket() const;
+
     /**
      * @brief Возвращает адрес сервера.
      * 
@@ -84,7 +321,65 @@ public:
     uint16_t getPort() const;
 
 private:
-    string address_; ///< Адрес сервера.
-    uint16_t port_;  ///< Порт сервера.
-    int socket_;     ///< Сокет подключения.
+    /**
+     * @brief Передаёт набор фрагментов целиком с учётом частичной отправки.
+     * 
+     * @param iov Массив фрагментов (изменяется в процессе передачи).
+     * @param count Количество фрагментов.
+     * @param what Описание передаваемых данных для сообщения об ошибке.
+     * @throws RuntimeError Если не удалось передать данные.
+     */
+    void sendIov(struct iovec *iov, size_t count, const string &what);
+
+    /**
+     * @brief Применяет параметры сокета, которые нужно задать до connect().
+     * 
+     * @throws RuntimeError Если ядро отклонило параметр.
+     */
+    void applySocketOptions();
+
+    /**
+     * @brief Включает немедленную отправку подтверждений перед ожиданием ответа.
+     * 
+     * Ядро сбрасывает TCP_QUICKACK после обработки входящих данных, поэтому флаг
+     * устанавливается заново перед каждым чтением ответа.
+     */
+    void armQuickAck();
+
+    /**
+     * @brief Выполняет запрос через io_uring.
+     * 
+     * @param data Векторы.
+     * @param begin Индекс первого вектора запроса.
+     * @param end Индекс, следующий за последним вектором запроса.
+     * @return Результаты вычислений.
+     * @throws RuntimeError Если не удалось передать данные или получить результат.
+     */
+    template <typename T>
+    vector<T> exchange(const BasicVectorBatch<T> &data, size_t begin, size_t end);
+
+    /**
+     * @brief Передаёт фрагменты запроса и принимает ответ через io_uring.
+     * 
+     * @param iov Фрагменты запроса (изменяются в процессе передачи).
+     * @param results Буфер для ответа.
+     * @param result_size Размер ответа в байтах.
+     * @throws RuntimeError Если не удалось передать данные или получить результат.
+     */
+    void exchangeRing(vector<struct iovec> &iov, void *results, size_t result_size);
+
+    string address_;          ///< Адрес сервера.
+    uint16_t port_;           ///< Порт сервера.
+    int socket_;              ///< Сокет подключения.
+    size_t batch_limit_;      ///< Максимальное количество фрагментов в одном вызове sendmsg().
+    SocketReader reader_;     ///< Буферизованное чтение ответов сервера.
+    string username_;         ///< Имя пользователя последней успешной аутентификации.
+    string password_;         ///< Пароль пользователя последней успешной аутентификации.
+    size_t completed_;        ///< Количество запросов, выполненных в текущем соединении.
+    size_t reconnects_;       ///< Количество переподключений.
+    SocketOptions options_;   ///< Параметры сокета.
+    IoBackend io_backend_;    ///< Способ обмена данными.
+    Deadline job_deadline_;   ///< Срок завершения всего задания.
+    Deadline phase_deadline_; ///< Срок завершения текущей фазы.
+    unique_ptr<IoRing> ring_; ///< Кольцо io_uring (создаётся при первом запросе).
 };
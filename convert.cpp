@@ -0,0 +1,166 @@
+#include "error.h"
+#include "data.h"
+#include <iostream>
+#include <cstring>
+
+using namespace std;
+
+/**
+ * @brief Показывает справку по параметрам конвертера.
+ */
+static void ShowHelp()
+{
+    cout << "Usage: convert [options] INPUT OUTPUT\n"
+         << "Converts an input data file between the legacy format and format v2.\n"
+         << "Options:\n"
+         << "  -h, --help            Show this help message and exit\n"
+         << "      --checksum        Store per-vector checksums in format v2 output\n"
+         << "      --to-legacy       Write the legacy format instead of format v2\n"
+         << "      --chunk-size N    Vectors converted per step (default: 4096)\n";
+}
+
+/**
+ * @brief Записывает входной файл в исходном формате.
+ * 
+ * @param reader Источник векторов.
+ * @param output_path Путь к выходному файлу.
+ * @param chunk_size Количество векторов, читаемых за один шаг.
+ * @throws RuntimeError Если не удалось записать файл.
+ */
+static void WriteLegacy(DataReader &reader, const string &output_path, size_t chunk_size)
+{
+    ofstream output_file(output_path, ios::binary);
+    if (!output_file.is_open())
+    {
+        throw RuntimeError("Failed to open output file \"" + output_path + "\"", __func__);
+    }
+
+    uint32_t count = reader.getCount();
+    output_file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    VectorBatch chunk;
+    while (reader.readChunk(chunk, chunk_size) > 0)
+    {
+        for (const auto &vec : chunk)
+        {
+            uint32_t size = vec.size();
+            output_file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+            output_file.write(reinterpret_cast<const char *>(vec.data()), size * sizeof(double));
+        }
+    }
+
+    output_file.close();
+    if (!output_file)
+    {
+        throw RuntimeError("Failed to write output file \"" + output_path + "\"", __func__);
+    }
+}
+
+/**
+ * @brief Записывает входной файл в формате v2.
+ * 
+ * @param reader Источник векторов.
+ * @param output_path Путь к выходному файлу.
+ * @param chunk_size Количество векторов, читаемых за один шаг.
+ * @param checksums Записывать ли контрольные суммы.
+ */
+static void WriteIndexed(DataReader &reader, const string &output_path, size_t chunk_size, bool checksums)
+{
+    IndexedWriter writer(output_path, reader.getCount(), checksums);
+    VectorBatch chunk;
+    while (reader.readChunk(chunk, chunk_size) > 0)
+    {
+        for (const auto &vec : chunk)
+        {
+            writer.append(vec);
+        }
+    }
+    writer.close();
+}
+
+/**
+ * @brief Главная функция конвертера входных файлов.
+ * 
+ * Читает входной файл любого поддерживаемого формата частями и записывает его
+ * в формате v2 или, с --to-legacy, в исходном формате.
+ * 
+ * @param argc Количество аргументов.
+ * @param argv Аргументы.
+ * @return Код завершения программы.
+ */
+int main(int argc, char *argv[])
+{
+    try
+    {
+        bool checksums = false;
+        bool to_legacy = false;
+        size_t chunk_size = 4096;
+        vector<string> paths;
+        for (int i = 1; i < argc; ++i)
+        {
+            if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+            {
+                ShowHelp();
+                return 0;
+            }
+            else if (strcmp(argv[i], "--checksum") == 0)
+            {
+                checksums = true;
+            }
+            else if (strcmp(argv[i], "--to-legacy") == 0)
+            {
+                to_legacy = true;
+            }
+            else if (strcmp(argv[i], "--chunk-size") == 0)
+            {
+                if (i + 1 < argc)
+                    chunk_size = stoul(argv[++i]);
+                else
+                    throw RuntimeError("Missing value for chunk size parameter", __func__);
+                if (chunk_size == 0)
+                    throw RuntimeError("Chunk size must be positive", __func__);
+            }
+            else if (argv[i][0] == '-')
+            {
+                throw RuntimeError("Unknown parameter: " + string(argv[i]), __func__);
+            }
+            else
+            {
+                paths.push_back(argv[i]);
+            }
+        }
+
+        if (paths.size() != 2)
+        {
+            ShowHelp();
+            return 1;
+        }
+        if (to_legacy && checksums)
+        {
+            throw RuntimeError("The legacy format cannot store checksums", __func__);
+        }
+
+        DataReader reader(paths[0]);
+        if (to_legacy)
+        {
+            WriteLegacy(reader, paths[1], chunk_size);
+        }
+        else
+        {
+            WriteIndexed(reader, paths[1], chunk_size, checksums);
+        }
+        cout << "[LOG] Converted " << reader.getCount() << " vectors from " << paths[0] << " to " << paths[1]
+             << (to_legacy ? " (legacy format)" : " (format v2)") << endl;
+    }
+    catch (const RuntimeError &e)
+    {
+        cerr << "[ERR] Runtime error: " << e.what() << endl;
+        return 1;
+    }
+    catch (const exception &e)
+    {
+        cerr << "[ERR] Error: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
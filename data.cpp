@@ -2,12 +2,638 @@
 #include "error.h"
 #include <sstream>
 #include <fstream>
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include <cfloat>
+#include <cerrno>
+#include <thread>
+#include <exception>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "metrics.h"
+#include "uring.h"
+
+// Размер окна чтения заголовков при построении индекса
+static const size_t INDEX_BLOCK = 1 << 20;
+
+// Максимальный объём одного чтения группы мелких векторов
+static const uint64_t LOAD_BLOCK = 8 << 20;
+
+// Минимальный объём файла на один поток чтения
+static const uint64_t MIN_BYTES_PER_THREAD = 4 << 20;
+
+// Количество одновременных чтений io_uring
+static const size_t RING_DEPTH = 4;
+
+/**
+ * @class InputFile
+ * @brief Дескриптор входного файла, закрываемый автоматически.
+ */
+class InputFile
+{
+public:
+    /**
+     * @brief Открывает файл для чтения.
+     * 
+     * @param path Путь к файлу.
+     * @throws RuntimeError Если файл не удалось открыть.
+     */
+    explicit InputFile(const string &path)
+        : fd_(::open(path.c_str(), O_RDONLY | O_CLOEXEC)), size_(0)
+    {
+        struct stat file_stat;
+        if (this->fd_ < 0 || fstat(this->fd_, &file_stat) < 0)
+        {
+            if (this->fd_ >= 0)
+            {
+                ::close(this->fd_);
+            }
+            throw RuntimeError("Failed to open input file for reading.", "readData");
+        }
+        this->size_ = file_stat.st_size;
+    }
+
+    ~InputFile()
+    {
+        ::close(this->fd_);
+    }
+
+    InputFile(const InputFile &) = delete;
+    InputFile &operator=(const InputFile &) = delete;
+
+    /**
+     * @brief Читает блок по смещению целиком.
+     * 
+     * @param dest Буфер назначения.
+     * @param size Количество байт.
+     * @param offset Смещение в файле.
+     * @throws RuntimeError Если файл закончился раньше или чтение не удалось.
+     */
+    void readAt(void *dest, size_t size, uint64_t offset) const
+    {
+        char *out = static_cast<char *>(dest);
+        while (size > 0)
+        {
+            ssize_t got = pread(this->fd_, out, size, offset);
+            Metrics::instance().count(Counter::ReadCalls);
+            if (got < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (got <= 0)
+            {
+                throw RuntimeError("Failed to read input file at offset " + to_string(offset), "readData");
+            }
+            Metrics::instance().count(Counter::BytesRead, got);
+            out += got;
+            size -= got;
+            offset += got;
+        }
+    }
+
+    /**
+     * @brief Возвращает размер файла.
+     * 
+     * @return Размер файла в байтах.
+     */
+    uint64_t size() const
+    {
+        return this->size_;
+    }
+
+    /**
+     * @brief Возвращает дескриптор файла.
+     * 
+     * @return Дескриптор файла.
+     */
+    int fd() const
+    {
+        return this->fd_;
+    }
+
+private:
+    int fd_;        ///< Дескриптор файла.
+    uint64_t size_; ///< Размер файла в байтах.
+};
+
+// Функция для разбора имени типа элементов
+ElementType ParseElementType(const string &name)
+{
+    if (name == "int16")
+    {
+        return ElementType::Int16;
+    }
+    if (name == "int32")
+    {
+        return ElementType::Int32;
+    }
+    if (name == "int64")
+    {
+        return ElementType::Int64;
+    }
+    if (name == "float")
+    {
+        return ElementType::Float;
+    }
+    if (name == "double")
+    {
+        return ElementType::Double;
+    }
+    throw RuntimeError("Unknown element type \"" + name + "\" (expected int16, int32, int64, float or double)", __func__);
+}
+
+// Функция для получения имени типа элементов
+const char *ElementTypeName(ElementType type)
+{
+    switch (type)
+    {
+    case ElementType::Int16:
+        return "int16";
+    case ElementType::Int32:
+        return "int32";
+    case ElementType::Int64:
+        return "int64";
+    case ElementType::Float:
+        return "float";
+    case ElementType::Double:
+        break;
+    }
+    return "double";
+}
+
+// Функция для получения размера значения
+size_t ElementSize(ElementType type)
+{
+    switch (type)
+    {
+    case ElementType::Int16:
+        return sizeof(int16_t);
+    case ElementType::Int32:
+        return sizeof(int32_t);
+    case ElementType::Int64:
+        return sizeof(int64_t);
+    case ElementType::Float:
+        return sizeof(float);
+    case ElementType::Double:
+        break;
+    }
+    return sizeof(double);
+}
+
+// Функция для вычисления контрольной суммы вектора
+uint32_t VectorChecksum(const double *values, size_t size)
+{
+    // Перемешивание по 8 байт за шаг: сдвиг переносит старшие биты произведения в младшие
+    uint64_t hash = 0x9E3779B97F4A7C15ull ^ size;
+    for (size_t i = 0; i < size; ++i)
+    {
+        uint64_t word;
+        memcpy(&word, values + i, sizeof(word));
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 29;
+    }
+
+    // Финальное перемешивание MurmurHash3, чтобы каждый бит влиял на младшие 32 бита
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+    return uint32_t(hash);
+}
+
+/**
+ * @brief Заголовок входного файла формата v2 (64 байта).
+ */
+struct FormatV2Header
+{
+    char magic[8];           ///< Признак формата FORMAT_V2_MAGIC.
+    uint32_t version;        ///< Версия формата.
+    uint32_t flags;          ///< Флаги FORMAT_V2_CHECKSUMS.
+    uint64_t count;          ///< Количество векторов.
+    uint64_t table_offset;   ///< Смещение таблицы VectorExtent.
+    uint64_t payload_offset; ///< Смещение первого вектора.
+    uint8_t reserved[24];    ///< Зарезервировано, заполняется нулями.
+};
+static_assert(sizeof(FormatV2Header) == 64, "Format v2 header must occupy 64 bytes");
+static_assert(sizeof(VectorExtent) == 16, "Format v2 table entry must occupy 16 bytes");
+
+// Признак формата v2 в начале файла
+static const char FORMAT_V2_MAGIC[8] = {'V', 'C', 'D', 'A', 'T', 'A', 'v', '2'};
+
+// Флаг наличия контрольных сумм векторов
+static const uint32_t FORMAT_V2_CHECKSUMS = 1;
+
+// Выравнивание начала каждого вектора в формате v2
+static const uint64_t FORMAT_V2_ALIGNMENT = 64;
+
+/**
+ * @brief Проверяет, начинается ли файл с признака формата v2.
+ * 
+ * @param file Входной файл.
+ * @return true для формата v2.
+ */
+static bool IsFormatV2(const InputFile &file)
+{
+    char magic[sizeof(FORMAT_V2_MAGIC)];
+    if (file.size() < sizeof(FormatV2Header))
+    {
+        return false;
+    }
+    file.readAt(magic, sizeof(magic), 0);
+    return memcmp(magic, FORMAT_V2_MAGIC, sizeof(magic)) == 0;
+}
+
+/**
+ * @brief Строит индекс векторов файла формата v2 по его таблице.
+ * 
+ * @param file Входной файл.
+ * @param checksums Устанавливается в true, если таблица содержит контрольные суммы.
+ * @return Положение и размер каждого вектора.
+ * @throws RuntimeError Если заголовок или таблица повреждены.
+ */
+static vector<VectorExtent> IndexVectorsV2(const InputFile &file, bool &checksums)
+{
+    FormatV2Header header;
+    file.readAt(&header, sizeof(header), 0);
+    if (header.version != 2)
+    {
+        throw RuntimeError("Unsupported input format version " + to_string(header.version), __func__);
+    }
+    if (header.count > UINT32_MAX || header.table_offset > file.size() ||
+        header.count * sizeof(VectorExtent) > file.size() - header.table_offset)
+    {
+        throw RuntimeError("Truncated vector table", __func__);
+    }
+
+    vector<VectorExtent> extents(header.count);
+    if (!extents.empty())
+    {
+        file.readAt(extents.data(), extents.size() * sizeof(VectorExtent), header.table_offset);
+    }
+    for (size_t i = 0; i < extents.size(); ++i)
+    {
+        if (extents[i].offset > file.size() || uint64_t(extents[i].size) * sizeof(double) > file.size() - extents[i].offset)
+        {
+            throw RuntimeError("Truncated data of vector " + to_string(i), __func__);
+        }
+    }
+    checksums = (header.flags & FORMAT_V2_CHECKSUMS) != 0;
+    return extents;
+}
+
+/**
+ * @brief Строит индекс векторов файла в исходном формате по заголовкам размеров.
+ * 
+ * Заголовки читаются окнами по INDEX_BLOCK байт, поэтому мелкие векторы
+ * индексируются последовательным чтением, а крупные пропускаются без чтения.
+ * 
+ * @param file Входной файл.
+ * @param element_size Размер одного значения в байтах.
+ * @return Положение и размер каждого вектора.
+ * @throws RuntimeError Если нарушена структура файла.
+ */
+static vector<VectorExtent> IndexVectorsV1(const InputFile &file, size_t element_size)
+{
+    uint32_t num_vectors;
+    if (file.size() < sizeof(num_vectors))
+    {
+        throw RuntimeError("Input file is too short to contain a header", __func__);
+    }
+    file.readAt(&num_vectors, sizeof(num_vectors), 0);
+
+    vector<VectorExtent> extents;
+    extents.reserve(num_vectors);
+    vector<char> window(INDEX_BLOCK);
+    uint64_t window_start = 0;
+    uint64_t window_size = 0;
+
+    uint64_t offset = sizeof(num_vectors);
+    for (uint32_t i = 0; i < num_vectors; ++i)
+    {
+        uint32_t vector_size;
+        if (offset + sizeof(vector_size) > file.size())
+        {
+            throw RuntimeError("Truncated size header of vector " + to_string(i), __func__);
+        }
+        if (offset < window_start || offset + sizeof(vector_size) > window_start + window_size)
+        {
+            window_start = offset;
+            window_size = min<uint64_t>(window.size(), file.size() - offset);
+            file.readAt(window.data(), window_size, window_start);
+        }
+        memcpy(&vector_size, window.data() + (offset - window_start), sizeof(vector_size));
+
+        extents.push_back({offset + sizeof(vector_size), vector_size, 0});
+        offset += sizeof(vector_size) + uint64_t(vector_size) * element_size;
+        if (offset > file.size())
+        {
+            throw RuntimeError("Truncated data of vector " + to_string(i), __func__);
+        }
+    }
+
+    if (offset != file.size())
+    {
+        throw RuntimeError("Unexpected trailing bytes after the last vector", __func__);
+    }
+    return extents;
+}
+
+/**
+ * @brief Строит индекс векторов файла любого поддерживаемого формата.
+ * 
+ * @param file Входной файл.
+ * @param checksums Устанавливается в true, если нужно проверять контрольные суммы.
+ * @param element_size Размер одного значения в байтах.
+ * @return Положение и размер каждого вектора.
+ * @throws RuntimeError Если файл формата v2 читается не как double.
+ */
+static vector<VectorExtent> IndexVectors(const InputFile &file, bool &checksums, size_t element_size = sizeof(double))
+{
+    checksums = false;
+    if (!IsFormatV2(file))
+    {
+        return IndexVectorsV1(file, element_size);
+    }
+    if (element_size != sizeof(double))
+    {
+        throw RuntimeError("Input file in format v2 stores double values only", "readData");
+    }
+    return IndexVectorsV2(file, checksums);
+}
+
+/**
+ * @brief Копирует значения вектора и проверяет его контрольную сумму.
+ * 
+ * @param vec Загруженный вектор.
+ * @param extent Описание вектора.
+ * @param checksums Проверять ли контрольную сумму.
+ * @param index Номер вектора для сообщения об ошибке.
+ * @throws RuntimeError Если контрольная сумма не совпала.
+ */
+template <typename T>
+static void CheckVector(VectorSpan<T>, const VectorExtent &, bool, size_t)
+{
+    // Контрольные суммы есть только в формате v2, который хранит double
+}
+
+static void CheckVector(VectorSpan<double> vec, const VectorExtent &extent, bool checksums, size_t index)
+{
+    if (checksums && VectorChecksum(vec.data(), vec.size()) != extent.checksum)
+    {
+        throw RuntimeError("Checksum mismatch in vector " + to_string(index), "readData");
+    }
+}
+
+/**
+ * @brief Чтение одного участка файла: группы соседних мелких векторов или одного крупного.
+ */
+struct ReadGroup
+{
+    uint64_t start; ///< Смещение начала участка.
+    uint64_t size;  ///< Размер участка в байтах.
+    size_t begin;   ///< Индекс первого вектора участка.
+    size_t end;     ///< Индекс за последним вектором участка.
+    bool direct;    ///< Вектор больше блока и читается прямо в свою память.
+};
+
+/**
+ * @brief Разбивает диапазон векторов на участки чтения.
+ * 
+ * Соседние мелкие векторы объединяются в участок до LOAD_BLOCK байт вместе с
+ * промежутками между ними, крупные векторы образуют отдельные участки.
+ * 
+ * @param extents Индекс векторов.
+ * @param begin Индекс первого вектора диапазона.
+ * @param end Индекс за последним вектором диапазона.
+ * @param element_size Размер одного значения в байтах.
+ * @return Участки чтения в порядке векторов.
+ */
+static vector<ReadGroup> PlanReads(const vector<VectorExtent> &extents, size_t begin, size_t end, size_t element_size)
+{
+    vector<ReadGroup> groups;
+    size_t i = begin;
+    while (i < end)
+    {
+        const uint64_t start = extents[i].offset;
+        uint64_t stop = start;
+        size_t group_end = i;
+        while (group_end < end && extents[group_end].offset >= stop &&
+               extents[group_end].offset + uint64_t(extents[group_end].size) * element_size - start <= LOAD_BLOCK)
+        {
+            stop = extents[group_end].offset + uint64_t(extents[group_end].size) * element_size;
+            ++group_end;
+        }
+
+        if (group_end == i)
+        {
+            groups.push_back({start, uint64_t(extents[i].size) * element_size, i, i + 1, true});
+            ++i;
+        }
+        else
+        {
+            groups.push_back({start, stop - start, i, group_end, false});
+            i = group_end;
+        }
+    }
+    return groups;
+}
+
+/**
+ * @brief Раскладывает прочитанный участок по векторам и проверяет контрольные суммы.
+ * 
+ * @param group Участок чтения.
+ * @param block Содержимое участка (не используется для прямого чтения).
+ * @param extents Индекс векторов.
+ * @param checksums Проверять ли контрольные суммы.
+ * @param data Векторы диапазона, data[0] соответствует extents[first].
+ * @param first Индекс вектора, соответствующего data[0].
+ */
+template <typename T>
+static void ScatterGroup(const ReadGroup &group, const char *block, const vector<VectorExtent> &extents, bool checksums,
+                         BasicVectorBatch<T> &data, size_t first)
+{
+    for (size_t i = group.begin; i < group.end; ++i)
+    {
+        if (!group.direct && extents[i].size > 0)
+        {
+            memcpy(data.data(i - first), block + (extents[i].offset - group.start), extents[i].size * sizeof(T));
+        }
+        CheckVector(data[i - first], extents[i], checksums, i);
+    }
+}
+
+/**
+ * @brief Загружает диапазон векторов по индексу блокирующими чтениями.
+ * 
+ * @param file Входной файл.
+ * @param extents Индекс векторов.
+ * @param begin Индекс первого вектора диапазона.
+ * @param end Индекс за последним вектором диапазона.
+ * @param checksums Проверять ли контрольные суммы.
+ * @param data Векторы диапазона с уже заданными размерами, data[0] соответствует extents[first].
+ * @param first Индекс вектора, соответствующего data[0].
+ */
+template <typename T>
+static void LoadVectors(const InputFile &file, const vector<VectorExtent> &extents, size_t begin, size_t end,
+                        bool checksums, BasicVectorBatch<T> &data, size_t first)
+{
+    vector<char> block;
+    for (const ReadGroup &group : PlanReads(extents, begin, end, sizeof(T)))
+    {
+        if (group.direct)
+        {
+            // Вектор больше блока: читаем значения без промежуточного буфера
+            file.readAt(data.data(group.begin - first), group.size, group.start);
+        }
+        else
+        {
+            block.resize(group.size);
+            file.readAt(block.data(), block.size(), group.start);
+        }
+        ScatterGroup(group, block.data(), extents, checksums, data, first);
+    }
+}
+
+/**
+ * @brief Загружает диапазон векторов по индексу через io_uring в одном потоке.
+ * 
+ * Участки читаются в RING_DEPTH зарегистрированных буферов: пока разбирается
+ * один участок, чтения остальных уже выполняются ядром, а новые чтения
+ * передаются пачкой одним io_uring_enter().
+ * 
+ * @param file Входной файл.
+ * @param extents Индекс векторов.
+ * @param begin Индекс первого вектора диапазона.
+ * @param end Индекс за последним вектором диапазона.
+ * @param checksums Проверять ли контрольные суммы.
+ * @param data Векторы диапазона с уже заданными размерами, data[0] соответствует extents[first].
+ * @param first Индекс вектора, соответствующего data[0].
+ * @throws RuntimeError Если чтение не удалось или файл закончился раньше.
+ */
+template <typename T>
+static void LoadVectorsRing(const InputFile &file, const vector<VectorExtent> &extents, size_t begin, size_t end,
+                            bool checksums, BasicVectorBatch<T> &data, size_t first)
+{
+    const vector<ReadGroup> groups = PlanReads(extents, begin, end, sizeof(T));
+    const size_t depth = min<size_t>(RING_DEPTH, groups.size());
+    if (depth == 0)
+    {
+        return;
+    }
+
+    IoRing ring(depth);
+    vector<vector<char>> blocks(depth, vector<char>(LOAD_BLOCK));
+    vector<struct iovec> buffers;
+    for (auto &block : blocks)
+    {
+        buffers.push_back({block.data(), block.size()});
+    }
+    bool fixed = true;
+    try
+    {
+        ring.registerBuffers(buffers);
+    }
+    catch (const RuntimeError &)
+    {
+        // Регистрация ограничена RLIMIT_MEMLOCK: читаем в те же буферы без регистрации
+        fixed = false;
+    }
+
+    // Для каждого буфера: номер читаемого участка и количество уже прочитанных байт
+    vector<size_t> slot_group(depth);
+    vector<uint64_t> slot_done(depth);
+    auto queue = [&](size_t slot) {
+        const ReadGroup &group = groups[slot_group[slot]];
+        const uint64_t done = slot_done[slot];
+        if (group.direct)
+        {
+            char *dest = reinterpret_cast<char *>(data.data(group.begin - first));
+            ring.prepareRead(file.fd(), dest + done, group.size - done, group.start + done, slot);
+        }
+        else if (fixed)
+        {
+            ring.prepareReadFixed(file.fd(), blocks[slot].data() + done, group.size - done, group.start + done, slot, slot);
+        }
+        else
+        {
+            ring.prepareRead(file.fd(), blocks[slot].data() + done, group.size - done, group.start + done, slot);
+        }
+        Metrics::instance().count(Counter::ReadCalls);
+    };
+
+    size_t next = 0;
+    size_t active = 0;
+    for (; next < depth; ++next, ++active)
+    {
+        slot_group[next] = next;
+        slot_done[next] = 0;
+        queue(next);
+    }
+
+    // После ошибки новые чтения не ставятся, но уже выполняемые дожидаются: ядро пишет в буферы
+    exception_ptr error;
+    while (active > 0)
+    {
+        ring.submit();
+        IoCompletion completion = ring.wait();
+        const size_t slot = completion.user_data;
+        const ReadGroup &group = groups[slot_group[slot]];
+        try
+        {
+            if (completion.result == -EINTR || completion.result == -EAGAIN)
+            {
+                queue(slot);
+                continue;
+            }
+            if (completion.result <= 0)
+            {
+                throw RuntimeError("Failed to read input file at offset " + to_string(group.start + slot_done[slot]), "readData");
+            }
+            Metrics::instance().count(Counter::BytesRead, completion.result);
+            slot_done[slot] += completion.result;
+            if (slot_done[slot] < group.size)
+            {
+                queue(slot);
+                continue;
+            }
+            ScatterGroup(group, blocks[slot].data(), extents, checksums, data, first);
+        }
+        catch (...)
+        {
+            if (!error)
+            {
+                error = current_exception();
+            }
+        }
+
+        if (!error && next < groups.size())
+        {
+            slot_group[slot] = next++;
+            slot_done[slot] = 0;
+            queue(slot);
+        }
+        else
+        {
+            --active;
+        }
+    }
+    if (error)
+    {
+        rethrow_exception(error);
+    }
+}
 
 // Конструктор
 DataHandler::DataHandler(const string &config_path, const string &input_path, const string &output_path)
     : config_path(config_path),
       input_path(input_path),
-      output_path(output_path) {}
+      output_path(output_path),
+      io_backend(IoBackend::Blocking) {}
 
 // Метод для чтения конфигурационных данных
 array<string, 2> DataHandler::loadConfig() const
@@ -36,54 +662,183 @@ array<string, 2> DataHandler::loadConfig() const
 }
 
 // Метод для чтения данных
-vector<vector<double>> DataHandler::readData() const
+template <typename T>
+BasicVectorBatch<T> DataHandler::readData() const
+{
+    return readData<T>(1);
+}
+
+template <typename T>
+BasicVectorBatch<T> DataHandler::readData(size_t threads) const
+{
+    return readRange<T>(0, SIZE_MAX, threads);
+}
+
+// Метод для чтения диапазона векторов
+template <typename T>
+BasicVectorBatch<T> DataHandler::readRange(size_t begin, size_t end, size_t threads) const
 {
-    ifstream input_file(this->input_path, ios::binary);
+    InputFile file(this->input_path);
+    bool checksums;
+    vector<VectorExtent> extents = IndexVectors(file, checksums, sizeof(T));
+    end = min(end, extents.size());
+    if (begin > end)
+    {
+        throw RuntimeError("Vector range " + to_string(begin) + ".." + to_string(end) + " is out of bounds", __func__);
+    }
+
+    // Границы диапазонов потоков делят данные на части примерно равного объёма
+    vector<uint64_t> bytes(end - begin + 1, 0);
+    for (size_t i = begin; i < end; ++i)
+    {
+        bytes[i - begin + 1] = bytes[i - begin] + sizeof(uint32_t) + uint64_t(extents[i].size) * sizeof(T);
+    }
+
+    // Мелкие файлы не стоят запуска потоков
+    if (threads == 0)
+    {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+    threads = max<uint64_t>(1, min<uint64_t>(threads, bytes.back() / MIN_BYTES_PER_THREAD));
+    threads = min<size_t>(threads, max<size_t>(1, end - begin));
+
+    // Все значения читаются в одну заранее размеченную область
+    BasicVectorBatch<T> data;
+    data.reserve(end - begin, (bytes.back() - (end - begin) * sizeof(uint32_t)) / sizeof(T));
+    for (size_t i = begin; i < end; ++i)
+    {
+        data.append(extents[i].size);
+    }
+
+    // io_uring держит несколько чтений в работе из одного потока
+    if (this->io_backend == IoBackend::Uring)
+    {
+        LoadVectorsRing(file, extents, begin, end, checksums, data, begin);
+        return data;
+    }
+    if (threads == 1)
+    {
+        LoadVectors(file, extents, begin, end, checksums, data, begin);
+        return data;
+    }
+
+    vector<size_t> bounds(threads + 1, end);
+    bounds[0] = begin;
+    for (size_t t = 1; t < threads; ++t)
+    {
+        uint64_t target = bytes.back() / threads * t;
+        bounds[t] = begin + (lower_bound(bytes.begin(), bytes.end() - 1, target) - bytes.begin());
+    }
+
+    vector<exception_ptr> errors(threads);
+    vector<thread> workers;
+    for (size_t t = 0; t < threads; ++t)
+    {
+        workers.push_back(thread([&, t]() {
+            try
+            {
+                LoadVectors(file, extents, bounds[t], bounds[t + 1], checksums, data, begin);
+            }
+            catch (...)
+            {
+                errors[t] = current_exception();
+            }
+        }));
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    for (const auto &error : errors)
+    {
+        if (error)
+        {
+            rethrow_exception(error);
+        }
+    }
+
+    return data;
+}
+
+// Метод для построения индекса векторов
+vector<VectorExtent> DataHandler::indexData() const
+{
+    InputFile file(this->input_path);
+    bool checksums;
+    return IndexVectors(file, checksums);
+}
+
+// Метод для определения версии формата
+uint32_t DataHandler::getFormatVersion() const
+{
+    InputFile file(this->input_path);
+    return IsFormatV2(file) ? 2 : 1;
+}
+
+// Метод для проверки структуры входного файла
+uint32_t DataHandler::scanData() const
+{
+    if (getFormatVersion() != 1)
+    {
+        throw RuntimeError("Input file is in format v2, which the server cannot read as is; "
+                           "convert it with \"convert --to-legacy\"", __func__);
+    }
+
+    ifstream input_file(this->input_path, ios::binary | ios::ate);
     if (!input_file.is_open())
     {
         throw RuntimeError("Failed to open input file for reading.", __func__);
     }
 
+    const uint64_t file_size = input_file.tellg();
+    input_file.seekg(0);
+
     uint32_t num_vectors;
-    input_file.read(reinterpret_cast<char *>(&num_vectors), sizeof(num_vectors));
+    if (!input_file.read(reinterpret_cast<char *>(&num_vectors), sizeof(num_vectors)))
+    {
+        throw RuntimeError("Input file is too short to contain a header", __func__);
+    }
 
-    vector<vector<double>> data(num_vectors);
+    // Переходим от заголовка к заголовку, не читая значения
+    uint64_t offset = sizeof(num_vectors);
     for (uint32_t i = 0; i < num_vectors; ++i)
     {
         uint32_t vector_size;
-        input_file.read(reinterpret_cast<char *>(&vector_size), sizeof(vector_size));
+        if (!input_file.read(reinterpret_cast<char *>(&vector_size), sizeof(vector_size)))
+        {
+            throw RuntimeError("Truncated size header of vector " + to_string(i), __func__);
+        }
 
-        vector<double> vec(vector_size);
-        for (uint32_t j = 0; j < vector_size; ++j)
+        offset += sizeof(vector_size) + uint64_t(vector_size) * sizeof(double);
+        if (offset > file_size)
         {
-            input_file.read(reinterpret_cast<char *>(&vec[j]), sizeof(double));
+            throw RuntimeError("Truncated data of vector " + to_string(i), __func__);
         }
+        input_file.seekg(offset);
+    }
 
-        data[i] = vec;
+    if (offset != file_size)
+    {
+        throw RuntimeError("Unexpected trailing bytes after the last vector", __func__);
     }
 
     input_file.close();
-    return data;
+    return num_vectors;
 }
 
 // Метод для записи данных
-void DataHandler::writeData(const vector<double> &data) const
+template <typename T>
+void DataHandler::writeData(const vector<T> &data) const
 {
-    ofstream output_file(this->output_path, ios::binary);
-    if (!output_file.is_open())
-    {
-        throw RuntimeError("Failed to open output file \"" + this->output_path + "\"", __func__);
-    }
-
-    uint32_t count = data.size();
-    output_file.write(reinterpret_cast<const char *>(&count), sizeof(count));
-
-    for (const auto &num : data)
-    {
-        output_file.write(reinterpret_cast<const char *>(&num), sizeof(num));
-    }
+    DataWriter writer(this->output_path, data.size(), sizeof(T));
+    writer.append(data);
+    writer.close();
+}
 
-    output_file.close();
+// Метод для выбора способа чтения
+void DataHandler::setIoBackend(IoBackend backend)
+{
+    this->io_backend = backend == IoBackend::Uring && IoRing::isSupported() ? IoBackend::Uring : IoBackend::Blocking;
 }
 
 // Методы для получения значений атрибутов
@@ -102,30 +857,401 @@ const string &DataHandler::getOutputPath() const
     return output_path;
 }
 
-// Функции для вывода
-void PrintVector(const vector<double> &data)
+// Конструктор потокового чтения
+DataReader::DataReader(const string &input_path)
+    : input_file_(input_path, ios::binary), file_size_(0), offset_(0), count_(0), position_(0), checksums_(false)
+{
+    if (!input_file_.is_open())
+    {
+        throw RuntimeError("Failed to open input file for reading.", __func__);
+    }
+
+    // В формате v2 векторы читаются по таблице
+    InputFile file(input_path);
+    file_size_ = file.size();
+    if (IsFormatV2(file))
+    {
+        extents_ = IndexVectorsV2(file, checksums_);
+        count_ = extents_.size();
+        return;
+    }
+
+    if (!input_file_.read(reinterpret_cast<char *>(&count_), sizeof(count_)))
+    {
+        throw RuntimeError("Input file is too short to contain a header", __func__);
+    }
+    offset_ = sizeof(count_);
+}
+
+uint32_t DataReader::getCount() const
+{
+    return count_;
+}
+
+// Метод для чтения очередной части векторов
+size_t DataReader::readChunk(VectorBatch &chunk, size_t max_vectors)
+{
+    chunk.clear();
+    while (position_ < count_ && chunk.size() < max_vectors)
+    {
+        if (!extents_.empty())
+        {
+            const VectorExtent &extent = extents_[position_];
+            chunk.append(extent.size);
+            input_file_.seekg(extent.offset);
+            if (!input_file_.read(reinterpret_cast<char *>(chunk.data(chunk.size() - 1)), extent.size * sizeof(double)))
+            {
+                throw RuntimeError("Truncated data of vector " + to_string(position_), __func__);
+            }
+            CheckVector(chunk[chunk.size() - 1], extent, checksums_, position_);
+            ++position_;
+            continue;
+        }
+
+        uint32_t vector_size;
+        if (!input_file_.read(reinterpret_cast<char *>(&vector_size), sizeof(vector_size)))
+        {
+            throw RuntimeError("Truncated size header of vector " + to_string(position_), __func__);
+        }
+
+        // Размер проверяется по остатку файла до выделения памяти под вектор
+        offset_ += sizeof(vector_size);
+        const uint64_t bytes = uint64_t(vector_size) * sizeof(double);
+        if (bytes > file_size_ - offset_)
+        {
+            throw RuntimeError("Truncated data of vector " + to_string(position_), __func__);
+        }
+
+        chunk.append(vector_size);
+        if (!input_file_.read(reinterpret_cast<char *>(chunk.data(chunk.size() - 1)), bytes))
+        {
+            throw RuntimeError("Truncated data of vector " + to_string(position_), __func__);
+        }
+        offset_ += bytes;
+        ++position_;
+    }
+    return chunk.size();
+}
+
+// Конструктор потоковой записи
+DataWriter::DataWriter(const string &output_path, uint32_t count, size_t element_size)
+    : fd_(::open(output_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)), mapping_(nullptr),
+      size_(sizeof(count) + uint64_t(count) * element_size), element_size_(element_size),
+      count_(count), written_(0)
+{
+    if (this->fd_ < 0)
+    {
+        throw RuntimeError("Failed to open output file \"" + output_path + "\"", __func__);
+    }
+
+    // Выделение места заранее: нехватка места обнаруживается здесь, а не при записи в отображение
+    int error = posix_fallocate(this->fd_, 0, this->size_);
+    if (error == EINVAL || error == EOPNOTSUPP)
+    {
+        // Файловая система не поддерживает выделение места: запись в отображение при нехватке
+        // места завершилась бы сигналом SIGBUS, поэтому результаты пишутся через pwrite()
+        writeAt(0, &this->count_, sizeof(this->count_));
+        return;
+    }
+    if (error != 0)
+    {
+        release();
+        throw RuntimeError("Failed to allocate " + to_string(this->size_) + " bytes for output file \"" + output_path +
+                           "\": " + strerror(error), __func__);
+    }
+
+    void *mapping = mmap(nullptr, this->size_, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd_, 0);
+    if (mapping == MAP_FAILED)
+    {
+        release();
+        throw RuntimeError("Failed to map output file \"" + output_path + "\"", __func__);
+    }
+    this->mapping_ = static_cast<char *>(mapping);
+    memcpy(this->mapping_, &this->count_, sizeof(this->count_));
+}
+
+DataWriter::~DataWriter()
 {
-    cout << "[ ";
-    for (const auto &val : data)
+    // Запись не завершена: файл укорачивается до записанных результатов, чтобы обрыв был виден.
+    // Деструктор не выбрасывает исключений, поэтому ошибка укорачивания не обрабатывается
+    if (this->fd_ >= 0)
     {
-        cout << fixed << setprecision(2) << val << " ";
+        int result = ftruncate(this->fd_, sizeof(this->count_) + uint64_t(this->written_) * this->element_size_);
+        (void)result;
     }
-    cout << "]";
-    cout << endl;
+    release();
 }
 
-void PrintVectors(const vector<vector<double>> &data)
+// Метод для записи через pwrite(), если файл не отображён в память
+void DataWriter::writeAt(uint64_t offset, const void *data, size_t size)
 {
-    cout << "[\n";
-    for (const auto &vec : data)
+    const char *bytes = static_cast<const char *>(data);
+    while (size > 0)
     {
-        cout << "  [ ";
-        for (const auto &val : vec)
+        ssize_t written = pwrite(this->fd_, bytes, size, offset);
+        if (written < 0 && errno == EINTR)
         {
-            cout << fixed << setprecision(2) << val << " ";
+            continue;
         }
-        cout << "]\n";
+        if (written <= 0)
+        {
+            throw RuntimeError("Failed to write output file: " + string(strerror(written < 0 ? errno : ENOSPC)), __func__);
+        }
+        bytes += written;
+        size -= written;
+        offset += written;
     }
-    cout << "]";
-    cout << endl;
 }
+
+// Метод для дописывания результатов
+template <typename T>
+void DataWriter::append(const vector<T> &data)
+{
+    if (sizeof(T) != this->element_size_)
+    {
+        throw RuntimeError("Result size " + to_string(sizeof(T)) + " does not match output element size " +
+                           to_string(this->element_size_), __func__);
+    }
+    if (data.size() > this->count_ - this->written_)
+    {
+        throw RuntimeError("More results than expected", __func__);
+    }
+
+    const uint64_t offset = sizeof(this->count_) + uint64_t(this->written_) * sizeof(T);
+    if (!data.empty() && this->mapping_ != nullptr)
+    {
+        memcpy(this->mapping_ + offset, data.data(), data.size() * sizeof(T));
+    }
+    else if (!data.empty())
+    {
+        writeAt(offset, data.data(), data.size() * sizeof(T));
+    }
+    this->written_ += data.size();
+}
+
+// Метод для завершения записи
+void DataWriter::close()
+{
+    if (this->written_ != this->count_)
+    {
+        throw RuntimeError("Only " + to_string(this->written_) + " of " + to_string(this->count_) + " results written", __func__);
+    }
+    release();
+}
+
+// Метод для освобождения отображения и дескриптора
+void DataWriter::release()
+{
+    if (this->mapping_ != nullptr)
+    {
+        munmap(this->mapping_, this->size_);
+        this->mapping_ = nullptr;
+    }
+    if (this->fd_ >= 0)
+    {
+        ::close(this->fd_);
+        this->fd_ = -1;
+    }
+}
+
+// Функция для загрузки списка заданий
+vector<Job> LoadManifest(const string &manifest_path)
+{
+    ifstream manifest_file(manifest_path);
+    if (!manifest_file.is_open())
+    {
+        throw RuntimeError("Failed to open manifest file \"" + manifest_path + "\"", __func__);
+    }
+
+    vector<Job> jobs;
+    string line;
+    size_t line_number = 0;
+    while (getline(manifest_file, line))
+    {
+        ++line_number;
+        istringstream iss(line);
+        Job job;
+        if (!(iss >> job.input_path) || job.input_path[0] == '#')
+        {
+            continue;
+        }
+
+        string extra;
+        if (!(iss >> job.output_path) || (iss >> extra))
+        {
+            throw RuntimeError("Invalid manifest line " + to_string(line_number) + ": \"" + line + "\"", __func__);
+        }
+        jobs.push_back(job);
+    }
+
+    return jobs;
+}
+
+// Функция для добавления значений вектора к строке
+template <typename T>
+static void AppendValues(string &out, VectorSpan<T> data, size_t limit)
+{
+    // Самая длинная запись "%.2f ": знак, DBL_MAX_10_EXP + 1 цифр, точка, 2 знака, пробел и '\0'
+    char buffer[DBL_MAX_10_EXP + 7];
+    out += "[ ";
+    size_t shown = min(limit, data.size());
+    for (size_t i = 0; i < shown; ++i)
+    {
+        int length = is_floating_point<T>::value ? snprintf(buffer, sizeof(buffer), "%.2f ", double(data[i]))
+                                                 : snprintf(buffer, sizeof(buffer), "%lld ", (long long)data[i]);
+        out.append(buffer, min<size_t>(length, sizeof(buffer) - 1));
+    }
+    if (shown < data.size())
+    {
+        out += "... (" + to_string(data.size() - shown) + " more) ";
+    }
+    out += "]";
+}
+
+// Функции для форматирования
+template <typename T>
+string FormatVector(VectorSpan<T> data, size_t limit)
+{
+    string out;
+    AppendValues(out, data, limit);
+    return out;
+}
+
+template <typename T>
+string FormatVectors(const BasicVectorBatch<T> &data, size_t limit)
+{
+    string out = "[\n";
+    size_t shown = min(limit, data.size());
+    for (size_t i = 0; i < shown; ++i)
+    {
+        out += "  ";
+        AppendValues(out, data[i], limit);
+        out += "\n";
+    }
+    if (shown < data.size())
+    {
+        out += "  ... (" + to_string(data.size() - shown) + " more vectors)\n";
+    }
+    out += "]";
+    return out;
+}
+
+// Функции для вывода
+void PrintVector(const vector<double> &data, size_t limit)
+{
+    cout << FormatVector(data, limit) << endl;
+}
+
+void PrintVectors(const VectorBatch &data, size_t limit)
+{
+    cout << FormatVectors(data, limit) << endl;
+}
+
+// Конструктор
+IndexedWriter::IndexedWriter(const string &output_path, uint32_t count, bool checksums)
+    : output_file_(output_path, ios::binary), count_(count), checksums_(checksums), offset_(0)
+{
+    if (!output_file_.is_open())
+    {
+        throw RuntimeError("Failed to open output file \"" + output_path + "\"", __func__);
+    }
+
+    // Заголовок и таблица заполняются при закрытии
+    this->extents_.reserve(count);
+    this->offset_ = sizeof(FormatV2Header) + uint64_t(count) * sizeof(VectorExtent);
+    vector<char> placeholder(this->offset_, 0);
+    output_file_.write(placeholder.data(), placeholder.size());
+}
+
+// Метод для добавления вектора
+void IndexedWriter::append(VectorSpan<double> vec)
+{
+    if (this->extents_.size() == this->count_)
+    {
+        throw RuntimeError("More vectors than expected", __func__);
+    }
+
+    static const char padding[FORMAT_V2_ALIGNMENT] = {};
+    uint64_t aligned = (this->offset_ + FORMAT_V2_ALIGNMENT - 1) / FORMAT_V2_ALIGNMENT * FORMAT_V2_ALIGNMENT;
+    output_file_.write(padding, aligned - this->offset_);
+    output_file_.write(reinterpret_cast<const char *>(vec.data()), vec.size() * sizeof(double));
+    if (!output_file_)
+    {
+        throw RuntimeError("Failed to write vector " + to_string(this->extents_.size()), __func__);
+    }
+
+    uint32_t checksum = this->checksums_ ? VectorChecksum(vec.data(), vec.size()) : 0;
+    this->extents_.push_back({aligned, uint32_t(vec.size()), checksum});
+    this->offset_ = aligned + vec.size() * sizeof(double);
+}
+
+// Метод для завершения записи
+void IndexedWriter::close()
+{
+    if (this->extents_.size() != this->count_)
+    {
+        throw RuntimeError("Only " + to_string(this->extents_.size()) + " of " + to_string(this->count_) + " vectors written", __func__);
+    }
+
+    FormatV2Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, FORMAT_V2_MAGIC, sizeof(header.magic));
+    header.version = 2;
+    header.flags = this->checksums_ ? FORMAT_V2_CHECKSUMS : 0;
+    header.count = this->count_;
+    header.table_offset = sizeof(FormatV2Header);
+    header.payload_offset = this->extents_.empty() ? this->offset_ : this->extents_.front().offset;
+
+    output_file_.seekp(header.table_offset);
+    output_file_.write(reinterpret_cast<const char *>(this->extents_.data()), this->extents_.size() * sizeof(VectorExtent));
+    output_file_.seekp(0);
+    output_file_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    output_file_.close();
+    if (!output_file_)
+    {
+        throw RuntimeError("Failed to write vector table", __func__);
+    }
+}
+
+// Явные инстанцирования для поддерживаемых типов элементов
+template BasicVectorBatch<int16_t> DataHandler::readData<int16_t>() const;
+template BasicVectorBatch<int32_t> DataHandler::readData<int32_t>() const;
+template BasicVectorBatch<int64_t> DataHandler::readData<int64_t>() const;
+template BasicVectorBatch<float> DataHandler::readData<float>() const;
+template BasicVectorBatch<double> DataHandler::readData<double>() const;
+
+template BasicVectorBatch<int16_t> DataHandler::readData<int16_t>(size_t) const;
+template BasicVectorBatch<int32_t> DataHandler::readData<int32_t>(size_t) const;
+template BasicVectorBatch<int64_t> DataHandler::readData<int64_t>(size_t) const;
+template BasicVectorBatch<float> DataHandler::readData<float>(size_t) const;
+template BasicVectorBatch<double> DataHandler::readData<double>(size_t) const;
+
+template BasicVectorBatch<int16_t> DataHandler::readRange<int16_t>(size_t, size_t, size_t) const;
+template BasicVectorBatch<int32_t> DataHandler::readRange<int32_t>(size_t, size_t, size_t) const;
+template BasicVectorBatch<int64_t> DataHandler::readRange<int64_t>(size_t, size_t, size_t) const;
+template BasicVectorBatch<float> DataHandler::readRange<float>(size_t, size_t, size_t) const;
+template BasicVectorBatch<double> DataHandler::readRange<double>(size_t, size_t, size_t) const;
+
+template void DataHandler::writeData<int16_t>(const vector<int16_t> &) const;
+template void DataHandler::writeData<int32_t>(const vector<int32_t> &) const;
+template void DataHandler::writeData<int64_t>(const vector<int64_t> &) const;
+template void DataHandler::writeData<float>(const vector<float> &) const;
+template void DataHandler::writeData<double>(const vector<double> &) const;
+
+template void DataWriter::append<int16_t>(const vector<int16_t> &);
+template void DataWriter::append<int32_t>(const vector<int32_t> &);
+template void DataWriter::append<int64_t>(const vector<int64_t> &);
+template void DataWriter::append<float>(const vector<float> &);
+template void DataWriter::append<double>(const vector<double> &);
+
+template string FormatVector<int16_t>(VectorSpan<int16_t>, size_t);
+template string FormatVector<int32_t>(VectorSpan<int32_t>, size_t);
+template string FormatVector<int64_t>(VectorSpan<int64_t>, size_t);
+template string FormatVector<float>(VectorSpan<float>, size_t);
+template string FormatVector<double>(VectorSpan<double>, size_t);
+
+template string FormatVectors<int16_t>(const BasicVectorBatch<int16_t> &, size_t);
+template string FormatVectors<int32_t>(const BasicVectorBatch<int32_t> &, size_t);
+template string FormatVectors<int64_t>(const BasicVectorBatch<int64_t> &, size_t);
+template string FormatVectors<float>(const BasicVectorBatch<float> &, size_t);
+template string FormatVectors<double>(const BasicVectorBatch<double> &, size_t);
@@ -7,10 +7,283 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <cstdint>
+#include <initializer_list>
+#include <algorithm>
 #include "error.h"
+#include "uring.h"
 
 using namespace std;
 
+/**
+ * @struct VectorExtent
+ * @brief Положение вектора во входном файле.
+ *
+ * В формате v2 совпадает с записью таблицы векторов.
+ */
+struct VectorExtent
+{
+    uint64_t offset;   ///< Смещение первого значения вектора.
+    uint32_t size;     ///< Количество значений.
+    uint32_t checksum; ///< Контрольная сумма значений (0, если не используется).
+};
+
+/**
+ * @class VectorSpan
+ * @brief Представление вектора без владения памятью: указатель на значения и их количество.
+ *
+ * Повторяет интерфейс const vector<T> для чтения (size(), empty(), data(),
+ * operator[], begin(), end()), поэтому код, работавший с vector<vector<T>>,
+ * работает и с VectorBatch без изменений.
+ */
+template <typename T>
+class VectorSpan
+{
+public:
+    VectorSpan() : data_(nullptr), size_(0) {}
+
+    /**
+     * @brief Конструктор представления участка памяти.
+     * 
+     * @param data Указатель на первое значение.
+     * @param size Количество значений.
+     */
+    VectorSpan(const T *data, size_t size) : data_(data), size_(size) {}
+
+    /**
+     * @brief Конструктор представления вектора.
+     * 
+     * @param vec Вектор, который должен жить дольше представления.
+     */
+    VectorSpan(const vector<T> &vec) : data_(vec.data()), size_(vec.size()) {}
+
+    const T *data() const { return this->data_; }
+    size_t size() const { return this->size_; }
+    bool empty() const { return this->size_ == 0; }
+    const T &operator[](size_t i) const { return this->data_[i]; }
+    const T *begin() const { return this->data_; }
+    const T *end() const { return this->data_ + this->size_; }
+
+    bool operator==(VectorSpan other) const
+    {
+        return this->size_ == other.size_ && equal(begin(), end(), other.begin());
+    }
+    bool operator!=(VectorSpan other) const { return !(*this == other); }
+
+private:
+    const T *data_; ///< Указатель на первое значение.
+    size_t size_;   ///< Количество значений.
+};
+
+/**
+ * @class BasicVectorBatch
+ * @brief Набор векторов в одной непрерывной области памяти.
+ *
+ * Значения всех векторов хранятся подряд в одном массиве, границы векторов - в
+ * массиве смещений, а вектор i доступен как VectorSpan. Миллионы коротких
+ * векторов занимают два выделения памяти вместо миллиона и читаются
+ * последовательно, без перехода по указателям.
+ */
+template <typename T>
+class BasicVectorBatch
+{
+public:
+    /**
+     * @class const_iterator
+     * @brief Итератор по векторам набора, возвращающий VectorSpan.
+     */
+    class const_iterator
+    {
+    public:
+        const_iterator(const BasicVectorBatch *batch, size_t index) : batch_(batch), index_(index) {}
+
+        VectorSpan<T> operator*() const { return (*this->batch_)[this->index_]; }
+        const_iterator &operator++()
+        {
+            ++this->index_;
+            return *this;
+        }
+        bool operator==(const const_iterator &other) const { return this->index_ == other.index_; }
+        bool operator!=(const const_iterator &other) const { return this->index_ != other.index_; }
+
+    private:
+        const BasicVectorBatch *batch_; ///< Набор векторов.
+        size_t index_;                  ///< Индекс текущего вектора.
+    };
+
+    BasicVectorBatch() : offsets_(1, 0) {}
+
+    /**
+     * @brief Конструктор набора из count пустых векторов.
+     * 
+     * @param count Количество векторов.
+     */
+    explicit BasicVectorBatch(size_t count) : offsets_(count + 1, 0) {}
+
+    /**
+     * @brief Конструктор из списка векторов, например {{1.0, 2.0}, {3.0}}.
+     * 
+     * @param vectors Значения векторов.
+     */
+    BasicVectorBatch(initializer_list<initializer_list<T>> vectors) : offsets_(1, 0)
+    {
+        for (const auto &vec : vectors)
+        {
+            push_back(VectorSpan<T>(vec.begin(), vec.size()));
+        }
+    }
+
+    /**
+     * @brief Конструктор копированием из вектора векторов.
+     * 
+     * @param vectors Векторы.
+     */
+    explicit BasicVectorBatch(const vector<vector<T>> &vectors) : offsets_(1, 0)
+    {
+        for (const auto &vec : vectors)
+        {
+            push_back(vec);
+        }
+    }
+
+    size_t size() const { return this->offsets_.size() - 1; }
+    bool empty() const { return size() == 0; }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    /**
+     * @brief Возвращает общее количество значений всех векторов.
+     * 
+     * @return Количество значений.
+     */
+    size_t elementCount() const { return this->values_.size(); }
+
+    VectorSpan<T> operator[](size_t i) const
+    {
+        return VectorSpan<T>(this->values_.data() + this->offsets_[i], this->offsets_[i + 1] - this->offsets_[i]);
+    }
+
+    /**
+     * @brief Возвращает изменяемый указатель на значения вектора.
+     * 
+     * Указатель действителен до следующего добавления вектора.
+     * 
+     * @param i Индекс вектора.
+     * @return Указатель на первое значение вектора i.
+     */
+    T *data(size_t i) { return this->values_.data() + this->offsets_[i]; }
+
+    /**
+     * @brief Резервирует память под векторы и значения.
+     * 
+     * @param vectors Количество векторов.
+     * @param elements Общее количество значений.
+     */
+    void reserve(size_t vectors, size_t elements)
+    {
+        this->offsets_.reserve(vectors + 1);
+        this->values_.reserve(elements);
+    }
+
+    /**
+     * @brief Добавляет вектор из size значений, заполненных нулями.
+     * 
+     * Значения заполняются позже через data(i), например при чтении файла.
+     * 
+     * @param size Количество значений.
+     */
+    void append(size_t size)
+    {
+        this->values_.resize(this->values_.size() + size);
+        this->offsets_.push_back(this->values_.size());
+    }
+
+    /**
+     * @brief Добавляет копию вектора.
+     * 
+     * @param vec Значения вектора.
+     */
+    void push_back(VectorSpan<T> vec)
+    {
+        this->values_.insert(this->values_.end(), vec.begin(), vec.end());
+        this->offsets_.push_back(this->values_.size());
+    }
+
+    void push_back(initializer_list<T> values)
+    {
+        push_back(VectorSpan<T>(values.begin(), values.size()));
+    }
+
+    bool operator==(const BasicVectorBatch &other) const
+    {
+        return this->offsets_ == other.offsets_ && this->values_ == other.values_;
+    }
+    bool operator!=(const BasicVectorBatch &other) const { return !(*this == other); }
+
+    /**
+     * @brief Удаляет все векторы, сохраняя выделенную память.
+     */
+    void clear()
+    {
+        this->values_.clear();
+        this->offsets_.assign(1, 0);
+    }
+
+private:
+    vector<T> values_;       ///< Значения всех векторов подряд.
+    vector<size_t> offsets_; ///< Начало каждого вектора в values_ и конец последнего.
+};
+
+/// Набор векторов значений double.
+typedef BasicVectorBatch<double> VectorBatch;
+
+/**
+ * @enum ElementType
+ * @brief Тип элементов векторов во входном файле, запросе и ответе сервера.
+ */
+enum class ElementType
+{
+    Int16,  ///< int16_t.
+    Int32,  ///< int32_t.
+    Int64,  ///< int64_t.
+    Float,  ///< float.
+    Double  ///< double (по умолчанию).
+};
+
+/**
+ * @brief Разбирает имя типа элементов.
+ * 
+ * @param name Имя типа: "int16", "int32", "int64", "float" или "double".
+ * @return Тип элементов.
+ * @throws RuntimeError Если имя типа не поддерживается.
+ */
+ElementType ParseElementType(const string &name);
+
+/**
+ * @brief Возвращает имя типа элементов.
+ * 
+ * @param type Тип элементов.
+ * @return Имя типа в том виде, в котором его принимает ParseElementType().
+ */
+const char *ElementTypeName(ElementType type);
+
+/**
+ * @brief Возвращает размер одного значения типа элементов.
+ * 
+ * @param type Тип элементов.
+ * @return Размер значения в байтах.
+ */
+size_t ElementSize(ElementType type);
+
+/**
+ * @brief Вычисляет контрольную сумму значений вектора для формата v2.
+ * 
+ * @param values Указатель на значения.
+ * @param size Количество значений.
+ * @return 32-битная контрольная сумма.
+ */
+uint32_t VectorChecksum(const double *values, size_t size);
+
 /**
  * @class DataHandler
  * @brief Класс для работы с данными.
@@ -40,10 +313,69 @@ public:
     /**
      * @brief Читает данные из входного файла.
      * 
+     * Методы чтения и записи параметризованы типом элементов T и явно
+     * инстанцированы для int16_t, int32_t, int64_t, float и double.
+     * 
      * @return Вектор векторов данных.
      * @throws RuntimeError Если не удалось открыть входной файл или произошла ошибка чтения данных.
      */
-    vector<vector<double>> readData() const;
+    template <typename T = double>
+    BasicVectorBatch<T> readData() const;
+
+    /**
+     * @brief Читает данные из входного файла в несколько потоков.
+     * 
+     * Сначала строит индекс смещений векторов, затем делит файл на диапазоны
+     * примерно равного объёма и читает их параллельно крупными блоками pread().
+     * 
+     * @param threads Количество потоков чтения (0 - по количеству ядер).
+     * @return Вектор векторов данных.
+     * @throws RuntimeError Если не удалось открыть входной файл или нарушена его структура.
+     */
+    template <typename T = double>
+    BasicVectorBatch<T> readData(size_t threads) const;
+
+    /**
+     * @brief Читает диапазон векторов входного файла.
+     * 
+     * В формате v2 индекс берётся из таблицы векторов, поэтому читаются только
+     * значения векторов диапазона.
+     * 
+     * @param begin Индекс первого вектора.
+     * @param end Индекс за последним вектором (ограничивается количеством векторов).
+     * @param threads Количество потоков чтения (0 - по количеству ядер).
+     * @return Векторы диапазона.
+     * @throws RuntimeError Если не удалось открыть входной файл, нарушена его структура,
+     *                      не совпала контрольная сумма или файл v2 читается не как double.
+     */
+    template <typename T = double>
+    BasicVectorBatch<T> readRange(size_t begin, size_t end, size_t threads = 1) const;
+
+    /**
+     * @brief Строит индекс векторов входного файла.
+     * 
+     * @return Положение и размер каждого вектора.
+     * @throws RuntimeError Если не удалось открыть входной файл или нарушена его структура.
+     */
+    vector<VectorExtent> indexData() const;
+
+    /**
+     * @brief Определяет версию формата входного файла.
+     * 
+     * @return 1 для исходного формата, 2 для формата v2.
+     * @throws RuntimeError Если не удалось открыть входной файл.
+     */
+    uint32_t getFormatVersion() const;
+
+    /**
+     * @brief Проверяет структуру входного файла, не читая сами значения.
+     * 
+     * Проходит только по заголовкам размеров векторов и сверяет их с размером файла.
+     * 
+     * @return Количество векторов во входном файле.
+     * @throws RuntimeError Если не удалось открыть входной файл или нарушена его структура.
+     */
+    uint32_t scanData() const;
 
     /**
      * @brief Записывает данные в выходной файл.
@@ -51,7 +383,8 @@ public:
      * @param data Вектор данных для записи.
      * @throws RuntimeError Если не удалось открыть выходной файл или произошла ошибка записи данных.
      */
-    void writeData(const vector<double> &data) const;
+    template <typename T>
+    void writeData(const vector<T> &data) const;
 
     /**
      * @brief Возвращает путь к файлу конфигурации.
@@ -74,22 +407,268 @@ public:
      */
     const string &getOutputPath() const;
 
+    /**
+     * @brief Выбирает способ чтения входного файла.
+     * 
+     * С IoBackend::Uring чтения участков файла передаются ядру пачками через io_uring
+     * из одного потока, а параметр threads не используется. Если io_uring недоступен,
+     * используется обычное чтение.
+     * 
+     * @param backend Способ ввода-вывода.
+     */
+    void setIoBackend(IoBackend backend);
+
 private:
-    string config_path; ///< Путь к файлу конфигурации.
+    string config_path;   ///< Путь к файлу конфигурации.
+    string input_path;    ///< Путь к входному файлу.
+    string output_path;   ///< Путь к выходному файлу.
+    IoBackend io_backend; ///< Способ чтения входного файла.
+};
+
+/**
+ * @class DataReader
+ * @brief Класс для последовательного чтения входного файла частями.
+ *
+ * В отличие от DataHandler::readData() не загружает файл целиком,
+ * что позволяет обрабатывать входные данные, превышающие объём памяти.
+ */
+class DataReader
+{
+public:
+    /**
+     * @brief Конструктор класса DataReader.
+     * 
+     * Открывает входной файл и читает количество векторов, а для формата v2 -
+     * также таблицу векторов.
+     * 
+     * @param input_path Путь к входному файлу.
+     * @throws RuntimeError Если не удалось открыть входной файл или прочитать заголовок.
+     */
+    explicit DataReader(const string &input_path);
+
+    /**
+     * @brief Возвращает общее количество векторов во входном файле.
+     * 
+     * @return Количество векторов.
+     */
+    uint32_t getCount() const;
+
+    /**
+     * @brief Читает очередную часть векторов.
+     * 
+     * @param chunk Набор, в который помещаются прочитанные векторы (предыдущее содержимое удаляется).
+     * @param max_vectors Максимальное количество векторов в части.
+     * @return Количество прочитанных векторов, 0 если файл прочитан полностью.
+     * @throws RuntimeError Если входной файл обрезан.
+     */
+    size_t readChunk(VectorBatch &chunk, size_t max_vectors);
+
+private:
+    ifstream input_file_;          ///< Входной файл.
+    uint64_t file_size_;           ///< Размер входного файла в байтах.
+    uint64_t offset_;              ///< Смещение следующего заголовка размера вектора (исходный формат).
+    uint32_t count_;               ///< Общее количество векторов.
+    uint32_t position_;            ///< Количество уже прочитанных векторов.
+    vector<VectorExtent> extents_; ///< Таблица векторов формата v2 (пуста для исходного формата).
+    bool checksums_;               ///< Проверять ли контрольные суммы.
+};
+
+/**
+ * @class DataWriter
+ * @brief Класс для записи результатов в выходной файл по мере их поступления.
+ *
+ * Размер выходного файла известен заранее, поэтому место под него выделяется
+ * сразу через fallocate(), а файл отображается в память: результаты копируются
+ * в страничный кэш одним memcpy() на каждую часть, без вызова write() на значение.
+ * Если файловая система не поддерживает fallocate(), результаты пишутся через pwrite().
+ * Если запись не завершена вызовом close(), файл укорачивается до фактически
+ * записанных результатов, поэтому заголовок не совпадает с размером файла.
+ */
+class DataWriter
+{
+public:
+    /**
+     * @brief Конструктор класса DataWriter.
+     * 
+     * Открывает выходной файл, выделяет место под все результаты, отображает
+     * файл в память и записывает заголовок с количеством результатов.
+     * 
+     * @param output_path Путь к выходному файлу.
+     * @param count Ожидаемое количество результатов.
+     * @param element_size Размер одного результата в байтах.
+     * @throws RuntimeError Если не удалось открыть выходной файл, выделить под него место
+     *                      или отобразить его в память.
+     */
+    DataWriter(const string &output_path, uint32_t count, size_t element_size = sizeof(double));
+
+    /**
+     * @brief Деструктор класса DataWriter. Освобождает отображение и дескриптор файла.
+     * 
+     * Если close() не был успешно вызван, укорачивает файл до записанных результатов.
+     */
+    ~DataWriter();
+
+    DataWriter(const DataWriter &) = delete;
+    DataWriter &operator=(const DataWriter &) = delete;
+
+    /**
+     * @brief Дописывает часть результатов в выходной файл.
+     * 
+     * Явно инстанцирован для int16_t, int32_t, int64_t, float и double.
+     * 
+     * @param data Вектор результатов.
+     * @throws RuntimeError Если результатов больше ожидаемого, размер результата
+     *                      не совпадает с заданным в конструкторе или не удалось записать файл.
+     */
+    template <typename T = double>
+    void append(const vector<T> &data);
+
+    /**
+     * @brief Завершает запись выходного файла.
+     * 
+     * @throws RuntimeError Если записаны не все ожидаемые результаты.
+     */
+    void close();
+
+private:
+    /**
+     * @brief Освобождает отображение и закрывает файл.
+     */
+    void release();
+
+    /**
+     * @brief Записывает байты по смещению через pwrite().
+     * 
+     * @param offset Смещение в файле.
+     * @param data Указатель на данные.
+     * @param size Количество байт.
+     * @throws RuntimeError Если запись не удалась, в том числе из-за нехватки места.
+     */
+    void writeAt(uint64_t offset, const void *data, size_t size);
+
+    int fd_;              ///< Дескриптор выходного файла.
+    char *mapping_;       ///< Отображение выходного файла в память.
+    uint64_t size_;       ///< Размер выходного файла в байтах.
+    size_t element_size_; ///< Размер одного результата в байтах.
+    uint32_t count_;      ///< Ожидаемое количество результатов.
+    uint32_t written_;    ///< Количество уже записанных результатов.
+};
+
+/**
+ * @class IndexedWriter
+ * @brief Класс для записи входного файла в формате v2.
+ *
+ * Формат v2: 64-байтовый заголовок с признаком "VCDATAv2", версией, флагами и
+ * количеством векторов, затем таблица VectorExtent, затем значения векторов,
+ * каждый с начала 64-байтовой границы. Таблица позволяет читать любые векторы
+ * без последовательного прохода, а выравнивание - обращаться к значениям
+ * в отображённом в память файле выровненными SIMD-инструкциями.
+ */
+class IndexedWriter
+{
+public:
+    /**
+     * @brief Конструктор класса IndexedWriter.
+     * 
+     * Резервирует место под заголовок и таблицу векторов.
+     * 
+     * @param output_path Путь к выходному файлу.
+     * @param count Количество векторов.
+     * @param checksums Записывать ли контрольные суммы векторов.
+     * @throws RuntimeError Если не удалось открыть выходной файл.
+     */
+    IndexedWriter(const string &output_path, uint32_t count, bool checksums);
+
+    /**
+     * @brief Дописывает вектор.
+     * 
+     * @param vec Вектор значений.
+     * @throws RuntimeError Если векторов больше ожидаемого или произошла ошибка записи.
+     */
+    void append(VectorSpan<double> vec);
+
+    /**
+     * @brief Записывает таблицу и заголовок и закрывает файл.
+     * 
+     * @throws RuntimeError Если записаны не все векторы или произошла ошибка записи.
+     */
+    void close();
+
+private:
+    ofstream output_file_;         ///< Выходной файл.
+    uint32_t count_;               ///< Ожидаемое количество векторов.
+    bool checksums_;               ///< Записывать ли контрольные суммы.
+    uint64_t offset_;              ///< Текущий размер файла.
+    vector<VectorExtent> extents_; ///< Таблица записанных векторов.
+};
+
+/**
+ * @struct Job
+ * @brief Пара входного и выходного файлов одного задания пакетного режима.
+ */
+struct Job
+{
     string input_path;  ///< Путь к входному файлу.
     string output_path; ///< Путь к выходному файлу.
 };
 
+/**
+ * @brief Загружает список заданий пакетного режима.
+ * 
+ * Каждая строка файла содержит путь к входному и путь к выходному файлу,
+ * разделённые пробелами. Пустые строки и строки, начинающиеся с '#', пропускаются.
+ * 
+ * @param manifest_path Путь к файлу списка заданий.
+ * @return Список заданий.
+ * @throws RuntimeError Если не удалось открыть файл или строка имеет неверный формат.
+ */
+vector<Job> LoadManifest(const string &manifest_path);
+
+/**
+ * @brief Форматирует вектор данных для вывода.
+ * 
+ * @param data Вектор данных.
+ * @param limit Максимальное количество выводимых значений, остальные заменяются счётчиком.
+ * @return Строка вида "[ 1.00 2.00 ]" (целые значения выводятся без дробной части).
+ */
+template <typename T>
+string FormatVector(VectorSpan<T> data, size_t limit = SIZE_MAX);
+
+/**
+ * @brief Форматирует вектор данных для вывода.
+ * 
+ * @param data Вектор данных.
+ * @param limit Максимальное количество выводимых значений.
+ * @return Строка вида "[ 1.00 2.00 ]".
+ */
+template <typename T = double>
+string FormatVector(const vector<T> &data, size_t limit = SIZE_MAX)
+{
+    return FormatVector(VectorSpan<T>(data), limit);
+}
+
+/**
+ * @brief Форматирует векторы данных для вывода.
+ * 
+ * @param data Вектор векторов данных.
+ * @param limit Максимальное количество выводимых векторов и значений в каждом векторе.
+ * @return Многострочное представление векторов.
+ */
+template <typename T = double>
+string FormatVectors(const BasicVectorBatch<T> &data, size_t limit = SIZE_MAX);
+
 /**
  * @brief Функция для красивого вывода вектора данных.
  * 
  * @param data Вектор данных для вывода.
+ * @param limit Максимальное количество выводимых значений.
  */
-void PrintVector(const vector<double> &data);
+void PrintVector(const vector<double> &data, size_t limit = SIZE_MAX);
 
 /**
  * @brief Функция для красивого вывода векторов данных.
  * 
  * @param data Вектор векторов данных для вывода.
+ * @param limit Максимальное количество выводимых векторов и значений в каждом векторе.
  */
-void PrintVectors(const vector<vector<double>> &data);
+void PrintVectors(const VectorBatch &data, size_t limit = SIZE_MAX);
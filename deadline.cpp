@@ -0,0 +1,78 @@
+#include "deadline.h"
+#include "metrics.h"
+#include <climits>
+#include <cerrno>
+#include <poll.h>
+
+// Конструкторы
+Deadline::Deadline()
+    : set_(false) {}
+
+Deadline::Deadline(chrono::milliseconds timeout)
+    : set_(true), until_(chrono::steady_clock::now() + timeout) {}
+
+Deadline::Deadline(chrono::steady_clock::time_point until)
+    : set_(true), until_(until) {}
+
+bool Deadline::isSet() const
+{
+    return this->set_;
+}
+
+bool Deadline::expired() const
+{
+    return this->set_ && chrono::steady_clock::now() >= this->until_;
+}
+
+// Метод для вычисления таймаута poll()
+int Deadline::remaining() const
+{
+    if (!this->set_)
+    {
+        return -1;
+    }
+    chrono::steady_clock::duration left = this->until_ - chrono::steady_clock::now();
+    if (left <= chrono::steady_clock::duration::zero())
+    {
+        return 0;
+    }
+    long long ms = chrono::duration_cast<chrono::milliseconds>(left + chrono::milliseconds(1) - chrono::nanoseconds(1)).count();
+    return ms > INT_MAX ? INT_MAX : static_cast<int>(ms);
+}
+
+Deadline Deadline::earliest(const Deadline &other) const
+{
+    if (!this->set_)
+    {
+        return other;
+    }
+    if (!other.set_ || this->until_ <= other.until_)
+    {
+        return *this;
+    }
+    return other;
+}
+
+// Функция для ожидания готовности сокета
+void WaitSocket(int socket, short events, const Deadline &deadline, const string &what)
+{
+    struct pollfd descriptor = {socket, events, 0};
+    while (true)
+    {
+        int ready = poll(&descriptor, 1, deadline.remaining());
+        Metrics::instance().count(Counter::PollCalls);
+        if (ready > 0)
+        {
+            // Ошибки сокета сообщит следующий системный вызов
+            return;
+        }
+        if (ready == 0)
+        {
+            throw TimeoutError("Timed out waiting to " + what, __func__);
+        }
+        if (errno != EINTR)
+        {
+            throw RuntimeError("Failed to wait for socket to " + what, __func__);
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "error.h"
+#include <string>
+#include <chrono>
+
+using namespace std;
+
+/**
+ * @class Deadline
+ * @brief Момент времени, до которого должна завершиться операция.
+ *
+ * Ограничение по умолчанию не задано: ожидание длится сколько угодно.
+ * Используется монотонное время, поэтому перевод системных часов не влияет на сроки.
+ */
+class Deadline
+{
+public:
+    /**
+     * @brief Конструктор класса Deadline без ограничения времени.
+     */
+    Deadline();
+
+    /**
+     * @brief Конструктор класса Deadline, отсчитывающий срок от текущего момента.
+     * 
+     * @param timeout Отведённое время.
+     */
+    explicit Deadline(chrono::milliseconds timeout);
+
+    /**
+     * @brief Конструктор класса Deadline с заданным моментом истечения.
+     * 
+     * @param until Момент истечения срока.
+     */
+    explicit Deadline(chrono::steady_clock::time_point until);
+
+    /**
+     * @brief Проверяет, задано ли ограничение.
+     * 
+     * @return true, если срок ограничен.
+     */
+    bool isSet() const;
+
+    /**
+     * @brief Проверяет, истёк ли срок.
+     * 
+     * @return true, если срок задан и уже наступил.
+     */
+    bool expired() const;
+
+    /**
+     * @brief Возвращает оставшееся время в формате таймаута poll().
+     * 
+     * Время округляется вверх, чтобы ожидание не завершилось раньше срока.
+     * 
+     * @return Миллисекунды до истечения срока, 0 если срок истёк, -1 если срок не задан.
+     */
+    int remaining() const;
+
+    /**
+     * @brief Возвращает более ранний из двух сроков.
+     * 
+     * @param other Другой срок.
+     * @return Срок, наступающий раньше (незаданный срок считается бесконечным).
+     */
+    Deadline earliest(const Deadline &other) const;
+
+private:
+    bool set_;                               ///< Задано ли ограничение.
+    chrono::steady_clock::time_point until_; ///< Момент истечения срока.
+};
+
+/**
+ * @brief Ждёт готовности сокета к чтению или записи, но не дольше срока.
+ * 
+ * @param socket Сокет.
+ * @param events События poll(): POLLIN или POLLOUT.
+ * @param deadline Срок ожидания.
+ * @param what Описание ожидаемой операции для сообщения об ошибке.
+ * @throws TimeoutError Если срок истёк раньше, чем сокет стал готов.
+ * @throws RuntimeError Если poll() завершился ошибкой.
+ */
+void WaitSocket(int socket, short events, const Deadline &deadline, const string &what);
@@ -0,0 +1,80 @@
+#include "dedup.h"
+#include <cstring>
+
+// Конструктор: поиск повторяющихся векторов
+Deduplicator::Deduplicator(const VectorBatch &data)
+    : data_(data), slots_(data.size())
+{
+    unordered_multimap<VectorKey, size_t, VectorKeyHash> seen;
+    seen.reserve(data.size());
+
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        VectorSpan<double> vec = data[i];
+        VectorKey key = HashVector(vec.data(), vec.size());
+
+        // Совпадение ключа проверяется побайтно, чтобы коллизия не подменила результат
+        bool found = false;
+        auto range = seen.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            VectorSpan<double> other = data[this->unique_[it->second]];
+            if (other.size() == vec.size() &&
+                (vec.empty() || memcmp(other.data(), vec.data(), vec.size() * sizeof(double)) == 0))
+            {
+                this->slots_[i] = it->second;
+                found = true;
+                break;
+            }
+        }
+
+        if (!found)
+        {
+            this->slots_[i] = this->unique_.size();
+            seen.insert(make_pair(key, this->unique_.size()));
+            this->unique_.push_back(i);
+        }
+    }
+}
+
+VectorBatch Deduplicator::unique() const
+{
+    VectorBatch vectors;
+    vectors.reserve(this->unique_.size(), this->data_.elementCount());
+    for (size_t index : this->unique_)
+    {
+        vectors.push_back(this->data_[index]);
+    }
+    return vectors;
+}
+
+// Метод для раздачи результатов
+vector<double> Deduplicator::expand(const vector<double> &unique_results) const
+{
+    if (unique_results.size() != this->unique_.size())
+    {
+        throw RuntimeError("Expected " + to_string(this->unique_.size()) + " results, got " + to_string(unique_results.size()), __func__);
+    }
+
+    vector<double> results(this->slots_.size());
+    for (size_t i = 0; i < this->slots_.size(); ++i)
+    {
+        results[i] = unique_results[this->slots_[i]];
+    }
+    return results;
+}
+
+size_t Deduplicator::getTotalCount() const
+{
+    return this->slots_.size();
+}
+
+size_t Deduplicator::getUniqueCount() const
+{
+    return this->unique_.size();
+}
+
+double Deduplicator::getRatio() const
+{
+    return this->unique_.empty() ? 1.0 : double(this->slots_.size()) / this->unique_.size();
+}
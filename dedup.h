@@ -0,0 +1,69 @@
+#pragma once
+
+#include "error.h"
+#include "cache.h"
+#include <vector>
+#include <unordered_map>
+
+using namespace std;
+
+/**
+ * @class Deduplicator
+ * @brief Класс для исключения повторяющихся векторов перед передачей.
+ *
+ * Находит векторы с одинаковым содержимым, оставляет для передачи по одному
+ * экземпляру и раздаёт полученные результаты всем исходным позициям.
+ * Векторы сравниваются по ключу содержимого, а при совпадении ключей — побайтно.
+ */
+class Deduplicator
+{
+public:
+    /**
+     * @brief Конструктор класса Deduplicator.
+     * 
+     * @param data Исходные векторы.
+     */
+    explicit Deduplicator(const VectorBatch &data);
+
+    /**
+     * @brief Возвращает уникальные векторы в порядке первого появления.
+     * 
+     * @return Уникальные векторы.
+     */
+    VectorBatch unique() const;
+
+    /**
+     * @brief Раздаёт результаты уникальных векторов всем исходным позициям.
+     * 
+     * @param unique_results Результаты уникальных векторов в порядке unique().
+     * @return Результаты для всех исходных векторов.
+     * @throws RuntimeError Если количество результатов не совпадает с количеством уникальных векторов.
+     */
+    vector<double> expand(const vector<double> &unique_results) const;
+
+    /**
+     * @brief Возвращает количество исходных векторов.
+     * 
+     * @return Количество исходных векторов.
+     */
+    size_t getTotalCount() const;
+
+    /**
+     * @brief Возвращает количество уникальных векторов.
+     * 
+     * @return Количество уникальных векторов.
+     */
+    size_t getUniqueCount() const;
+
+    /**
+     * @brief Возвращает коэффициент сжатия — отношение исходного количества векторов к уникальному.
+     * 
+     * @return Коэффициент сжатия (1, если повторов нет).
+     */
+    double getRatio() const;
+
+private:
+    const VectorBatch &data_; ///< Исходные векторы.
+    vector<size_t> unique_;   ///< Индексы первых экземпляров уникальных векторов.
+    vector<size_t> slots_;    ///< Номер уникального вектора для каждой исходной позиции.
+};
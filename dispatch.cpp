@@ -0,0 +1,569 @@
+#include "dispatch.h"
+#include "metrics.h"
+#include "logger.h"
+#include <algorithm>
+#include <climits>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+// Вес нового измерения в сглаженной оценке времени обработки вектора
+static const double LATENCY_WEIGHT = 0.3;
+
+// Метка события eventfd в epoll (серверы помечаются своими номерами)
+static const uint32_t WAKEUP_INDEX = UINT32_MAX;
+
+// Конструктор
+Dispatcher::Dispatcher(const vector<Endpoint> &endpoints, size_t window)
+    : window_(max<size_t>(1, window)), done_(0), epoll_(-1), wakeup_(-1), timeout_(0)
+{
+    if (endpoints.empty())
+    {
+        throw RuntimeError("Empty server list", __func__);
+    }
+
+    for (const auto &endpoint : endpoints)
+    {
+        Server server;
+        server.client.reset(new Client(endpoint.address, endpoint.port));
+        server.alive = false;
+        server.window = this->window_;
+        server.completed = 0;
+        server.pending = 0;
+        server.out_index = 0;
+        server.in_bytes = 0;
+        server.stats = {endpoint, false, 0, 0, 0.0};
+        this->servers_.push_back(move(server));
+    }
+}
+
+Dispatcher::~Dispatcher()
+{
+    closeConnections();
+}
+
+void Dispatcher::setSocketOptions(const SocketOptions &options)
+{
+    for (auto &server : this->servers_)
+    {
+        server.client->setSocketOptions(options);
+    }
+    this->timeout_ = options.timeout;
+}
+
+void Dispatcher::setJobDeadline(const Deadline &deadline)
+{
+    for (auto &server : this->servers_)
+    {
+        server.client->setJobDeadline(deadline);
+    }
+    this->deadline_ = deadline;
+}
+
+// Метод для подключения ко всем серверам
+size_t Dispatcher::connect(const string &username, const string &password)
+{
+    this->epoll_ = epoll_create1(0);
+    if (this->epoll_ < 0)
+    {
+        throw RuntimeError("Failed to create epoll instance", __func__);
+    }
+
+    // Потоки переподключения сообщают о завершении через eventfd
+    this->wakeup_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event wakeup_event;
+    memset(&wakeup_event, 0, sizeof(wakeup_event));
+    wakeup_event.events = EPOLLIN;
+    wakeup_event.data.u32 = WAKEUP_INDEX;
+    if (this->wakeup_ < 0 || epoll_ctl(this->epoll_, EPOLL_CTL_ADD, this->wakeup_, &wakeup_event) < 0)
+    {
+        throw RuntimeError("Failed to create reconnect notification", __func__);
+    }
+
+    size_t alive = 0;
+    size_t timed_out = 0;
+    for (size_t i = 0; i < this->servers_.size(); ++i)
+    {
+        Server &server = this->servers_[i];
+        try
+        {
+            server.client->connectToServer();
+            server.client->authenticate(username, password);
+        }
+        catch (const RuntimeError &e)
+        {
+            server.client->closeConnection();
+            if (this->deadline_.expired())
+            {
+                throw TimeoutError("Job deadline expired while connecting to servers", __func__);
+            }
+
+            // Недоступный сервер просто не участвует в работе
+            LogError() << "Server " << server.stats.endpoint.address << ":" << server.stats.endpoint.port
+                       << " is unavailable: " << e.what();
+            if (dynamic_cast<const TimeoutError *>(&e) != nullptr)
+            {
+                ++timed_out;
+            }
+            continue;
+        }
+        watch(i);
+        ++alive;
+    }
+
+    // Если ни один сервер не ответил в срок, запуск завершается как по истечении срока
+    if (alive == 0 && timed_out == this->servers_.size())
+    {
+        throw TimeoutError("No server answered within " + to_string(this->timeout_) + " ms", __func__);
+    }
+    if (alive == 0)
+    {
+        throw RuntimeError("No server is available", __func__);
+    }
+    return alive;
+}
+
+// Метод для распределённых вычислений
+vector<double> Dispatcher::calculate(const VectorBatch &data, size_t chunk_size)
+{
+    chunk_size = max<size_t>(1, chunk_size);
+    vector<double> results(data.size());
+    this->done_ = 0;
+    this->backlog_.clear();
+    for (size_t begin = 0; begin < data.size(); begin += chunk_size)
+    {
+        this->backlog_.push_back(make_pair(begin, min(data.size(), begin + chunk_size)));
+    }
+
+    epoll_event events[16];
+    while (this->done_ < data.size())
+    {
+        // Раздаём части, пока у серверов есть место в окне
+        while (!this->backlog_.empty())
+        {
+            const pair<size_t, size_t> range = this->backlog_.front();
+            int index = pickServer(range.second - range.first);
+            if (index < 0)
+            {
+                break;
+            }
+            this->backlog_.pop_front();
+            enqueue(index, data, range.first, range.second);
+        }
+
+        if (none_of(this->servers_.begin(), this->servers_.end(),
+                    [](const Server &server) { return server.alive || server.reconnected.valid(); }))
+        {
+            throw RuntimeError("All servers failed", __func__);
+        }
+
+        // Ожидание не дольше срока задания и срока самой старой части в обработке
+        Deadline wake = this->deadline_;
+        for (const auto &server : this->servers_)
+        {
+            if (this->timeout_ > 0 && server.alive && !server.in_flight.empty())
+            {
+                wake = wake.earliest(Deadline(server.in_flight.front().sent + chrono::milliseconds(this->timeout_)));
+            }
+        }
+
+        int ready = epoll_wait(this->epoll_, events, sizeof(events) / sizeof(events[0]), wake.remaining());
+        Metrics::instance().count(Counter::PollCalls);
+        if (ready < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw RuntimeError("Failed to wait for socket events", __func__);
+        }
+
+        for (int i = 0; i < ready; ++i)
+        {
+            if (events[i].data.u32 == WAKEUP_INDEX)
+            {
+                // Завершилось одно или несколько переподключений
+                uint64_t signals;
+                ssize_t got = read(this->wakeup_, &signals, sizeof(signals));
+                (void)got;
+                for (size_t index = 0; index < this->servers_.size(); ++index)
+                {
+                    const future<void> &reconnected = this->servers_[index].reconnected;
+                    if (reconnected.valid() && reconnected.wait_for(chrono::seconds(0)) == future_status::ready)
+                    {
+                        finishReconnect(index);
+                    }
+                }
+                continue;
+            }
+
+            const size_t index = events[i].data.u32;
+            if (!this->servers_[index].alive)
+            {
+                continue;
+            }
+            try
+            {
+                if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+                {
+                    drain(index, results);
+                }
+                if (this->servers_[index].alive && (events[i].events & EPOLLOUT))
+                {
+                    flush(index);
+                }
+            }
+            catch (const RuntimeError &)
+            {
+                fail(index);
+            }
+        }
+
+        if (this->deadline_.expired())
+        {
+            throw TimeoutError("Job deadline expired with " + to_string(data.size() - this->done_) + " results outstanding", __func__);
+        }
+
+        // Сервер, не ответивший на часть в срок, считается зависшим, его части уходят другим
+        for (size_t index = 0; index < this->servers_.size() && this->timeout_ > 0; ++index)
+        {
+            const Server &server = this->servers_[index];
+            if (server.alive && !server.in_flight.empty() &&
+                Deadline(server.in_flight.front().sent + chrono::milliseconds(this->timeout_)).expired())
+            {
+                LogError() << "Server " << server.stats.endpoint.address << ":" << server.stats.endpoint.port
+                           << " timed out after " << this->timeout_ << " ms";
+                fail(index);
+            }
+        }
+    }
+
+    return results;
+}
+
+// Метод для выбора сервера
+int Dispatcher::pickServer(size_t count) const
+{
+    int best = -1;
+    double best_score = 0.0;
+    for (size_t i = 0; i < this->servers_.size(); ++i)
+    {
+        const Server &server = this->servers_[i];
+        if (!server.alive || server.in_flight.size() >= server.window)
+        {
+            continue;
+        }
+
+        // Ожидаемое время до получения результатов этой части; неизмеренный сервер выбирается первым
+        double score = (server.pending + count) * server.stats.latency;
+        if (best < 0 || score < best_score ||
+            (score == best_score && server.pending < this->servers_[best].pending))
+        {
+            best = i;
+            best_score = score;
+        }
+    }
+    return best;
+}
+
+// Метод для постановки части в очередь отправки
+void Dispatcher::enqueue(size_t index, const VectorBatch &data, size_t begin, size_t end)
+{
+    Server &server = this->servers_[index];
+
+    // Количество векторов, затем размер и значения каждого вектора; адреса элементов deque не меняются при добавлении
+    const size_t count = end - begin;
+    server.sizes.push_back(count);
+    server.out.push_back({&server.sizes.back(), sizeof(uint32_t)});
+    for (size_t i = begin; i < end; ++i)
+    {
+        VectorSpan<double> vec = data[i];
+        server.sizes.push_back(vec.size());
+        server.out.push_back({&server.sizes.back(), sizeof(uint32_t)});
+        if (!vec.empty())
+        {
+            server.out.push_back({const_cast<double *>(vec.data()), vec.size() * sizeof(double)});
+        }
+    }
+
+    server.in_flight.push_back({begin, end, chrono::steady_clock::now()});
+    server.pending += count;
+    updateEvents(index);
+}
+
+// Метод для отправки накопленных данных
+void Dispatcher::flush(size_t index)
+{
+    Server &server = this->servers_[index];
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    while (server.out_index < server.out.size())
+    {
+        msg.msg_iov = server.out.data() + server.out_index;
+        msg.msg_iovlen = min<size_t>(server.out.size() - server.out_index, IOV_MAX);
+        ssize_t sent = sendmsg(server.client->getSocket(), &msg, MSG_NOSIGNAL);
+        Metrics::instance().count(Counter::SendCalls);
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            throw RuntimeError("Failed to send vectors", __func__);
+        }
+        Metrics::instance().count(Counter::BytesSent, sent);
+
+        // Пропуск полностью отправленных фрагментов и сдвиг частично отправленного
+        size_t remaining = sent;
+        while (server.out_index < server.out.size() && remaining >= server.out[server.out_index].iov_len)
+        {
+            remaining -= server.out[server.out_index].iov_len;
+            ++server.out_index;
+        }
+        if (remaining > 0)
+        {
+            struct iovec &partial = server.out[server.out_index];
+            partial.iov_base = static_cast<char *>(partial.iov_base) + remaining;
+            partial.iov_len -= remaining;
+        }
+    }
+
+    if (server.out_index == server.out.size())
+    {
+        server.out.clear();
+        server.sizes.clear();
+        server.out_index = 0;
+    }
+    updateEvents(index);
+}
+
+// Метод для приёма доступных результатов
+void Dispatcher::drain(size_t index, vector<double> &results)
+{
+    Server &server = this->servers_[index];
+    while (true)
+    {
+        if (server.in_flight.empty())
+        {
+            // Данные без запроса или закрытие простаивающего соединения
+            char byte;
+            ssize_t received = recv(server.client->getSocket(), &byte, sizeof(byte), 0);
+            Metrics::instance().count(Counter::RecvCalls);
+            if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+            {
+                return;
+            }
+            throw RuntimeError("Unexpected data or connection close", __func__);
+        }
+
+        // Результаты первой части в обработке принимаются прямо на их место
+        const Request &request = server.in_flight.front();
+        const size_t total = (request.end - request.begin) * sizeof(double);
+        char *dest = reinterpret_cast<char *>(results.data() + request.begin);
+        ssize_t received = recv(server.client->getSocket(), dest + server.in_bytes, total - server.in_bytes, 0);
+        Metrics::instance().count(Counter::RecvCalls);
+        if (received < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                return;
+            }
+            throw RuntimeError("Failed to receive results", __func__);
+        }
+        if (received == 0)
+        {
+            throw RuntimeError("Connection closed while receiving results", __func__);
+        }
+
+        server.in_bytes += received;
+        Metrics::instance().count(Counter::BytesReceived, received);
+        if (server.in_bytes < total)
+        {
+            continue;
+        }
+
+        // Часть обработана: обновляем оценку времени обработки вектора
+        const size_t count = request.end - request.begin;
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - request.sent).count();
+        double per_vector = elapsed / max<size_t>(1, count);
+        server.stats.latency = server.stats.latency == 0.0
+                                   ? per_vector
+                                   : (1 - LATENCY_WEIGHT) * server.stats.latency + LATENCY_WEIGHT * per_vector;
+        server.stats.vectors += count;
+        server.pending -= count;
+        server.in_bytes = 0;
+        server.in_flight.pop_front();
+        ++server.completed;
+
+        // Время ожидания следующей части за только что завершённой не относится к её обработке
+        if (!server.in_flight.empty())
+        {
+            server.in_flight.front().sent = max(server.in_flight.front().sent, chrono::steady_clock::now());
+        }
+        this->done_ += count;
+    }
+}
+
+// Метод для обработки обрыва соединения
+void Dispatcher::fail(size_t index)
+{
+    Server &server = this->servers_[index];
+    ++server.stats.failures;
+
+    // Сервер, обрабатывающий один запрос на соединение, сбрасывает его при втором запросе в обработке
+    const bool pipelined = server.in_flight.size() > 1 && server.completed <= 1;
+    if (pipelined)
+    {
+        server.window = 1;
+    }
+
+    // Части оборвавшегося сервера возвращаются в начало общей очереди
+    for (auto it = server.in_flight.rbegin(); it != server.in_flight.rend(); ++it)
+    {
+        this->backlog_.push_front(make_pair(it->begin, it->end));
+    }
+    server.in_flight.clear();
+    server.pending = 0;
+    server.out.clear();
+    server.sizes.clear();
+    server.out_index = 0;
+    server.in_bytes = 0;
+
+    const bool reused = server.completed > 0 || pipelined;
+    server.alive = false;
+    server.stats.alive = false;
+    server.client->closeConnection();
+
+    // Сервер мог закрыть соединение после предыдущего запроса. Подключение и аутентификация
+    // блокируют поток, поэтому выполняются отдельно, а остальные серверы продолжают работу
+    if (reused)
+    {
+        promise<void> result;
+        server.reconnected = result.get_future();
+        Client *client = server.client.get();
+        const int wakeup = this->wakeup_;
+        server.reconnector = thread([client, wakeup](promise<void> done) {
+            try
+            {
+                client->reconnect();
+                done.set_value();
+            }
+            catch (...)
+            {
+                done.set_exception(current_exception());
+            }
+            uint64_t signal = 1;
+            ssize_t written = write(wakeup, &signal, sizeof(signal));
+            (void)written;
+        }, move(result));
+        return;
+    }
+
+    LogError() << "Server " << server.stats.endpoint.address << ":" << server.stats.endpoint.port
+               << " dropped, its vectors are moved to other servers";
+}
+
+// Метод для завершения переподключения
+void Dispatcher::finishReconnect(size_t index)
+{
+    Server &server = this->servers_[index];
+    server.reconnector.join();
+    try
+    {
+        server.reconnected.get();
+        watch(index);
+        return;
+    }
+    catch (const RuntimeError &)
+    {
+        server.client->closeConnection();
+    }
+
+    LogError() << "Server " << server.stats.endpoint.address << ":" << server.stats.endpoint.port
+               << " dropped, its vectors are moved to other servers";
+}
+
+// Метод для ожидания потоков переподключения
+void Dispatcher::joinReconnectors()
+{
+    for (auto &server : this->servers_)
+    {
+        if (server.reconnector.joinable())
+        {
+            server.reconnector.join();
+        }
+        server.reconnected = future<void>();
+    }
+}
+
+// Метод для регистрации сокета в epoll
+void Dispatcher::watch(size_t index)
+{
+    Server &server = this->servers_[index];
+    int fd = server.client->getSocket();
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u32 = index;
+    if (epoll_ctl(this->epoll_, EPOLL_CTL_ADD, fd, &event) < 0)
+    {
+        throw RuntimeError("Failed to register socket in epoll", __func__);
+    }
+
+    server.alive = true;
+    server.stats.alive = true;
+    server.completed = 0;
+}
+
+// Метод для обновления ожидаемых событий
+void Dispatcher::updateEvents(size_t index)
+{
+    Server &server = this->servers_[index];
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | (server.out_index < server.out.size() ? uint32_t(EPOLLOUT) : 0u);
+    event.data.u32 = index;
+    epoll_ctl(this->epoll_, EPOLL_CTL_MOD, server.client->getSocket(), &event);
+}
+
+// Метод для закрытия всех соединений
+void Dispatcher::closeConnections()
+{
+    joinReconnectors();
+    for (auto &server : this->servers_)
+    {
+        server.client->closeConnection();
+        server.alive = false;
+        server.stats.alive = false;
+    }
+    if (this->epoll_ >= 0)
+    {
+        ::close(this->epoll_);
+        this->epoll_ = -1;
+    }
+    if (this->wakeup_ >= 0)
+    {
+        ::close(this->wakeup_);
+        this->wakeup_ = -1;
+    }
+}
+
+vector<ServerStats> Dispatcher::getStats() const
+{
+    vector<ServerStats> stats;
+    for (const auto &server : this->servers_)
+    {
+        stats.push_back(server.stats);
+    }
+    return stats;
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "error.h"
+#include "client.h"
+#include "terminal.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <future>
+#include <sys/uio.h>
+
+using namespace std;
+
+/**
+ * @struct ServerStats
+ * @brief Статистика работы с одним сервером.
+ */
+struct ServerStats
+{
+    Endpoint endpoint; ///< Адрес и порт сервера.
+    bool alive;        ///< Доступен ли сервер.
+    size_t vectors;    ///< Количество векторов, обработанных сервером.
+    size_t failures;   ///< Количество обрывов соединения.
+    double latency;    ///< Сглаженное время обработки одного вектора, с.
+};
+
+/**
+ * @class Dispatcher
+ * @brief Класс для распределения вычислений между несколькими серверами.
+ *
+ * Держит по одному аутентифицированному неблокирующему соединению с каждым
+ * сервером и обслуживает их в одном потоке с помощью epoll. Очередная часть
+ * векторов отправляется серверу с наименьшей ожидаемой задержкой, которая
+ * оценивается по количеству векторов в обработке и измеренному времени
+ * обработки одного вектора. Части оборвавшегося сервера передаются остальным.
+ * Переподключение к оборвавшемуся серверу выполняется в отдельном потоке, чтобы
+ * не останавливать обмен с остальными серверами; о его завершении цикл epoll
+ * узнаёт через eventfd.
+ */
+class Dispatcher
+{
+public:
+    /**
+     * @brief Конструктор класса Dispatcher.
+     * 
+     * @param endpoints Список серверов.
+     * @param window Максимальное количество частей, одновременно находящихся в обработке на одном сервере.
+     */
+    Dispatcher(const vector<Endpoint> &endpoints, size_t window = 2);
+
+    /**
+     * @brief Деструктор класса Dispatcher.
+     */
+    ~Dispatcher();
+
+    /**
+     * @brief Устанавливает параметры сокета для подключений ко всем серверам.
+     * 
+     * @param options Параметры сокета.
+     */
+    void setSocketOptions(const SocketOptions &options);
+
+    /**
+     * @brief Устанавливает срок завершения задания.
+     * 
+     * @param deadline Срок задания.
+     */
+    void setJobDeadline(const Deadline &deadline);
+
+    /**
+     * @brief Подключается и аутентифицируется на всех доступных серверах.
+     * 
+     * @param username Имя пользователя.
+     * @param password Пароль пользователя.
+     * @return Количество доступных серверов.
+     * @throws TimeoutError Если истёк срок задания или ни один сервер не ответил в срок.
+     * @throws RuntimeError Если не доступен ни один сервер.
+     */
+    size_t connect(const string &username, const string &password);
+
+    /**
+     * @brief Выполняет вычисления, распределяя части векторов между серверами.
+     * 
+     * @param data Данные для вычислений в виде вектора векторов.
+     * @param chunk_size Количество векторов в одной части.
+     * @return Результаты вычислений в исходном порядке векторов.
+     * @throws TimeoutError Если истёк срок задания.
+     * @throws RuntimeError Если все серверы стали недоступны.
+     */
+    vector<double> calculate(const VectorBatch &data, size_t chunk_size);
+
+    /**
+     * @brief Закрывает все соединения.
+     */
+    void closeConnections();
+
+    /**
+     * @brief Возвращает статистику по серверам.
+     * 
+     * @return Статистика по каждому серверу в порядке списка.
+     */
+    vector<ServerStats> getStats() const;
+
+private:
+    /**
+     * @brief Часть векторов, отправленная серверу.
+     */
+    struct Request
+    {
+        size_t begin;                          ///< Индекс первого вектора части.
+        size_t end;                            ///< Индекс, следующий за последним вектором части.
+        chrono::steady_clock::time_point sent; ///< Момент начала обработки части.
+    };
+
+    /**
+     * @brief Состояние соединения с одним сервером.
+     */
+    struct Server
+    {
+        unique_ptr<Client> client; ///< Клиент соединения.
+        bool alive;                ///< Доступен ли сервер.
+        size_t window;             ///< Максимальное количество частей в обработке на этом сервере.
+        size_t completed;          ///< Количество частей, обработанных в текущем соединении.
+        deque<Request> in_flight;  ///< Части в обработке в порядке отправки.
+        size_t pending;            ///< Количество векторов в обработке.
+        deque<uint32_t> sizes;     ///< Количества и размеры векторов, на которые указывают фрагменты out.
+        vector<struct iovec> out;  ///< Фрагменты частей над векторами исходного набора, ещё не отправленные.
+        size_t out_index;          ///< Номер первого не отправленного полностью фрагмента out.
+        size_t in_bytes;           ///< Количество байт результатов, полученных для первой части в обработке.
+        thread reconnector;        ///< Поток переподключения к серверу.
+        future<void> reconnected;  ///< Результат переподключения (действителен, пока оно не обработано).
+        ServerStats stats;         ///< Статистика сервера.
+    };
+
+    /**
+     * @brief Выбирает сервер для очередной части.
+     * 
+     * @param count Количество векторов в части.
+     * @return Номер сервера или -1, если у всех серверов заполнено окно.
+     */
+    int pickServer(size_t count) const;
+
+    /**
+     * @brief Ставит часть в очередь отправки сервера.
+     * 
+     * Фрагменты указывают прямо на значения векторов в data, поэтому данные
+     * не копируются; data должен жить до отправки части.
+     */
+    void enqueue(size_t index, const VectorBatch &data, size_t begin, size_t end);
+
+    /**
+     * @brief Отправляет накопленные данные, пока сокет принимает их.
+     */
+    void flush(size_t index);
+
+    /**
+     * @brief Принимает доступные результаты в вектор результатов.
+     */
+    void drain(size_t index, vector<double> &results);
+
+    /**
+     * @brief Обрабатывает обрыв соединения с сервером.
+     * 
+     * Возвращает его части в общую очередь и, если соединение уже использовалось
+     * или в нём было несколько частей, начинает переподключение в отдельном потоке;
+     * иначе сервер исключается из работы. Сервер, оборвавший соединение с несколькими
+     * частями в обработке, дальше получает части по одной.
+     */
+    void fail(size_t index);
+
+    /**
+     * @brief Завершает переподключение, результат которого уже готов.
+     * 
+     * При успехе сервер снова участвует в работе, иначе исключается из неё.
+     */
+    void finishReconnect(size_t index);
+
+    /**
+     * @brief Дожидается завершения всех потоков переподключения.
+     */
+    void joinReconnectors();
+
+    /**
+     * @brief Переводит сокет сервера в неблокирующий режим и регистрирует его в epoll.
+     */
+    void watch(size_t index);
+
+    /**
+     * @brief Обновляет набор ожидаемых событий сервера.
+     */
+    void updateEvents(size_t index);
+
+    vector<Server> servers_;              ///< Серверы.
+    deque<pair<size_t, size_t>> backlog_; ///< Части, ожидающие отправки.
+    size_t window_;                       ///< Максимальное количество частей в обработке на сервере.
+    size_t done_;                         ///< Количество полученных результатов.
+    int epoll_;                           ///< Дескриптор epoll.
+    int wakeup_;                          ///< eventfd, сигнализирующий о завершении переподключения.
+    int timeout_;                         ///< Срок обработки одной части в миллисекундах (0 - без ограничения).
+    Deadline deadline_;                   ///< Срок завершения задания.
+};
@@ -0,0 +1,259 @@
+#include "engine.h"
+#include <cmath>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ENGINE_X86 1
+#endif
+
+// Последовательная свёртка, повторяющая порядок вычислений сервера
+static double ReduceScalar(const double *values, size_t size, Reduction reduction)
+{
+    double result = reduction == Reduction::Product ? 1.0 : 0.0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        switch (reduction)
+        {
+        case Reduction::Product:
+            result *= values[i];
+            break;
+        case Reduction::SumOfSquares:
+            result += values[i] * values[i];
+            break;
+        default:
+            result += values[i];
+            break;
+        }
+    }
+    return result;
+}
+
+#ifdef ENGINE_X86
+// Свёртка на SSE2: два независимых аккумулятора по 2 элемента
+static double ReduceSse2(const double *values, size_t size, Reduction reduction)
+{
+    const bool product = reduction == Reduction::Product;
+    __m128d acc0 = _mm_set1_pd(product ? 1.0 : 0.0);
+    __m128d acc1 = acc0;
+
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4)
+    {
+        __m128d a = _mm_loadu_pd(values + i);
+        __m128d b = _mm_loadu_pd(values + i + 2);
+        if (product)
+        {
+            acc0 = _mm_mul_pd(acc0, a);
+            acc1 = _mm_mul_pd(acc1, b);
+        }
+        else if (reduction == Reduction::SumOfSquares)
+        {
+            acc0 = _mm_add_pd(acc0, _mm_mul_pd(a, a));
+            acc1 = _mm_add_pd(acc1, _mm_mul_pd(b, b));
+        }
+        else
+        {
+            acc0 = _mm_add_pd(acc0, a);
+            acc1 = _mm_add_pd(acc1, b);
+        }
+    }
+
+    double lanes[4];
+    _mm_storeu_pd(lanes, acc0);
+    _mm_storeu_pd(lanes + 2, acc1);
+    double tail = ReduceScalar(values + i, size - i, reduction);
+    if (product)
+    {
+        return lanes[0] * lanes[1] * lanes[2] * lanes[3] * tail;
+    }
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + tail;
+}
+
+// Свёртка на AVX2: два независимых аккумулятора по 4 элемента
+__attribute__((target("avx2"))) static double ReduceAvx2(const double *values, size_t size, Reduction reduction)
+{
+    const bool product = reduction == Reduction::Product;
+    __m256d acc0 = _mm256_set1_pd(product ? 1.0 : 0.0);
+    __m256d acc1 = acc0;
+
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        __m256d a = _mm256_loadu_pd(values + i);
+        __m256d b = _mm256_loadu_pd(values + i + 4);
+        if (product)
+        {
+            acc0 = _mm256_mul_pd(acc0, a);
+            acc1 = _mm256_mul_pd(acc1, b);
+        }
+        else if (reduction == Reduction::SumOfSquares)
+        {
+            acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(a, a));
+            acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(b, b));
+        }
+        else
+        {
+            acc0 = _mm256_add_pd(acc0, a);
+            acc1 = _mm256_add_pd(acc1, b);
+        }
+    }
+
+    double lanes[8];
+    _mm256_storeu_pd(lanes, acc0);
+    _mm256_storeu_pd(lanes + 4, acc1);
+    double tail = ReduceScalar(values + i, size - i, reduction);
+    double result = tail;
+    for (double lane : lanes)
+    {
+        result = product ? result * lane : result + lane;
+    }
+    return result;
+}
+#endif
+
+// Функции для разбора названий
+Reduction ParseReduction(const string &name)
+{
+    if (name == "sum")
+        return Reduction::Sum;
+    if (name == "product")
+        return Reduction::Product;
+    if (name == "mean")
+        return Reduction::Mean;
+    if (name == "sumsq")
+        return Reduction::SumOfSquares;
+    throw RuntimeError("Unknown reduction: " + name, __func__);
+}
+
+Kernel ParseKernel(const string &name)
+{
+    if (name == "auto")
+        return Kernel::Auto;
+    if (name == "scalar")
+        return Kernel::Scalar;
+    if (name == "sse2")
+        return Kernel::Sse2;
+    if (name == "avx2")
+        return Kernel::Avx2;
+    throw RuntimeError("Unknown kernel: " + name, __func__);
+}
+
+// Конструктор
+LocalEngine::LocalEngine(Reduction reduction, Kernel kernel)
+    : reduction_(reduction), kernel_(kernel)
+{
+    if (kernel == Kernel::Auto)
+    {
+        this->kernel_ = isSupported(Kernel::Avx2) ? Kernel::Avx2
+                        : isSupported(Kernel::Sse2) ? Kernel::Sse2
+                                                    : Kernel::Scalar;
+    }
+    else if (!isSupported(kernel))
+    {
+        throw RuntimeError("Kernel " + getKernelName() + " is not supported by this CPU", __func__);
+    }
+}
+
+// Метод для проверки поддержки набора инструкций
+bool LocalEngine::isSupported(Kernel kernel)
+{
+    switch (kernel)
+    {
+#ifdef ENGINE_X86
+    case Kernel::Sse2:
+        return __builtin_cpu_supports("sse2");
+    case Kernel::Avx2:
+        return __builtin_cpu_supports("avx2");
+#else
+    case Kernel::Sse2:
+    case Kernel::Avx2:
+        return false;
+#endif
+    default:
+        return true;
+    }
+}
+
+// Метод для свёртки всех векторов
+vector<double> LocalEngine::calculate(const VectorBatch &data) const
+{
+    vector<double> results(data.size());
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        VectorSpan<double> vec = data[i];
+        results[i] = reduce(vec.data(), vec.size());
+    }
+    return results;
+}
+
+// Метод для свёртки одного вектора
+double LocalEngine::reduce(const double *values, size_t size) const
+{
+    double result;
+    switch (this->kernel_)
+    {
+#ifdef ENGINE_X86
+    case Kernel::Avx2:
+        result = ReduceAvx2(values, size, this->reduction_);
+        break;
+    case Kernel::Sse2:
+        result = ReduceSse2(values, size, this->reduction_);
+        break;
+#endif
+    default:
+        result = ReduceScalar(values, size, this->reduction_);
+        break;
+    }
+
+    if (this->reduction_ == Reduction::Mean)
+    {
+        return size == 0 ? 0.0 : result / size;
+    }
+    return result;
+}
+
+Kernel LocalEngine::getKernel() const
+{
+    return this->kernel_;
+}
+
+string LocalEngine::getKernelName() const
+{
+    switch (this->kernel_)
+    {
+    case Kernel::Avx2:
+        return "avx2";
+    case Kernel::Sse2:
+        return "sse2";
+    case Kernel::Scalar:
+        return "scalar";
+    default:
+        return "auto";
+    }
+}
+
+// Функция для сравнения результатов
+size_t CountMismatches(const vector<double> &expected, const vector<double> &actual, double tolerance)
+{
+    if (expected.size() != actual.size())
+    {
+        return max(expected.size(), actual.size());
+    }
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        const double a = expected[i];
+        const double b = actual[i];
+        if (a == b || (std::isnan(a) && std::isnan(b)))
+        {
+            continue;
+        }
+        if (!(fabs(a - b) <= tolerance * max(1.0, max(fabs(a), fabs(b)))))
+        {
+            ++mismatches;
+        }
+    }
+    return mismatches;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "error.h"
+#include "data.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * @brief Операция свёртки вектора в одно число.
+ */
+enum class Reduction
+{
+    Sum,         ///< Сумма элементов.
+    Product,     ///< Произведение элементов.
+    Mean,        ///< Среднее арифметическое элементов.
+    SumOfSquares ///< Сумма квадратов элементов.
+};
+
+/**
+ * @brief Набор инструкций, которым выполняется свёртка.
+ */
+enum class Kernel
+{
+    Auto,   ///< Лучший набор, поддерживаемый процессором.
+    Scalar, ///< Без векторных инструкций.
+    Sse2,   ///< SSE2, 2 элемента за инструкцию.
+    Avx2    ///< AVX2, 4 элемента за инструкцию.
+};
+
+/**
+ * @brief Разбирает название операции свёртки.
+ * 
+ * @param name Название: sum, product, mean или sumsq.
+ * @return Операция свёртки.
+ * @throws RuntimeError Если название неизвестно.
+ */
+Reduction ParseReduction(const string &name);
+
+/**
+ * @brief Разбирает название набора инструкций.
+ * 
+ * @param name Название: auto, scalar, sse2 или avx2.
+ * @return Набор инструкций.
+ * @throws RuntimeError Если название неизвестно.
+ */
+Kernel ParseKernel(const string &name);
+
+/**
+ * @class LocalEngine
+ * @brief Класс для вычислений на стороне клиента без обращения к серверу.
+ *
+ * Выполняет ту же свёртку векторов, что и сервер для типа double. Векторный
+ * набор инструкций выбирается во время выполнения по возможностям процессора.
+ * Из-за другого порядка сложения результаты векторных вариантов могут
+ * отличаться от последовательного вычисления в последних разрядах.
+ */
+class LocalEngine
+{
+public:
+    /**
+     * @brief Конструктор класса LocalEngine.
+     * 
+     * @param reduction Операция свёртки.
+     * @param kernel Набор инструкций.
+     * @throws RuntimeError Если выбранный набор инструкций не поддерживается процессором.
+     */
+    explicit LocalEngine(Reduction reduction, Kernel kernel = Kernel::Auto);
+
+    /**
+     * @brief Выполняет свёртку каждого вектора.
+     * 
+     * @param data Данные для вычислений в виде вектора векторов.
+     * @return Результаты вычислений в виде вектора.
+     */
+    vector<double> calculate(const VectorBatch &data) const;
+
+    /**
+     * @brief Выполняет свёртку одного вектора.
+     * 
+     * @param values Указатель на элементы вектора.
+     * @param size Количество элементов.
+     * @return Результат свёртки.
+     */
+    double reduce(const double *values, size_t size) const;
+
+    /**
+     * @brief Возвращает выбранный набор инструкций.
+     * 
+     * @return Набор инструкций (никогда не Kernel::Auto).
+     */
+    Kernel getKernel() const;
+
+    /**
+     * @brief Возвращает название выбранного набора инструкций.
+     * 
+     * @return Название набора инструкций.
+     */
+    string getKernelName() const;
+
+    /**
+     * @brief Проверяет, поддерживает ли процессор набор инструкций.
+     * 
+     * @param kernel Набор инструкций.
+     * @return true, если набор поддерживается.
+     */
+    static bool isSupported(Kernel kernel);
+
+private:
+    Reduction reduction_; ///< Операция свёртки.
+    Kernel kernel_;       ///< Выбранный набор инструкций.
+};
+
+/**
+ * @brief Сравнивает результаты сервера с локально вычисленными.
+ * 
+ * @param expected Локально вычисленные результаты.
+ * @param actual Результаты сервера.
+ * @param tolerance Допустимая относительная погрешность (для чисел меньше 1 — абсолютная).
+ * @return Количество несовпадающих результатов.
+ */
+size_t CountMismatches(const vector<double> &expected, const vector<double> &actual, double tolerance = 1e-9);
@@ -2,3 +2,6 @@
 
 RuntimeError::RuntimeError(const string &message, const string &func)
     : runtime_error(message + " in function: " + func) {}
+
+TimeoutError::TimeoutError(const string &message, const string &func)
+    : RuntimeError(message, func) {}
@@ -23,3 +23,22 @@ public:
      */
     RuntimeError(const string &message, const string &func);
 };
+
+/**
+ * @class TimeoutError
+ * @brief Класс для ошибок истечения срока ожидания.
+ *
+ * Выбрасывается, когда фаза обмена с сервером или всё задание не уложились
+ * в отведённое время. Позволяет отличить зависший сервер от прочих ошибок.
+ */
+class TimeoutError : public RuntimeError
+{
+public:
+    /**
+     * @brief Конструктор класса TimeoutError.
+     * 
+     * @param message Сообщение об ошибке.
+     * @param func Имя функции, в которой истёк срок.
+     */
+    TimeoutError(const string &message, const string &func);
+};
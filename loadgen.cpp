@@ -0,0 +1,347 @@
+#include "error.h"
+#include "data.h"
+#include "client.h"
+#include "loopback.h"
+#include "stats.h"
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstring>
+
+using namespace std;
+
+/**
+ * @brief Параметры нагрузочного прогона.
+ */
+struct LoadOptions
+{
+    string address = "127.0.0.1";                 ///< Адрес сервера.
+    uint16_t port = 33333;                        ///< Порт сервера.
+    string config_path = "./config/vclient.conf"; ///< Путь к файлу с логином и паролем.
+    size_t sessions = 4;                          ///< Количество параллельных сессий.
+    double rate = 0;                              ///< Суммарная частота запросов в секунду (0 - без ограничения).
+    double duration = 10;                         ///< Длительность прогона в секундах.
+    uint32_t vectors = 100;                       ///< Количество векторов в запросе.
+    uint32_t length = 64;                         ///< Длина каждого вектора.
+    size_t session_requests = 0;                  ///< Запросов на сессию до переподключения (0 - без переподключения).
+    bool loopback = false;                        ///< Поднять локальный сервер вместо внешнего.
+};
+
+/**
+ * @brief Результаты одного потока нагрузки.
+ */
+struct LoadResult
+{
+    LatencyStats connect;        ///< Замеры подключения.
+    LatencyStats auth;           ///< Замеры аутентификации.
+    LatencyStats calculate;      ///< Замеры запросов вычисления.
+    size_t connect_errors = 0;   ///< Ошибки подключения.
+    size_t auth_errors = 0;      ///< Ошибки аутентификации.
+    size_t calculate_errors = 0; ///< Ошибки запросов вычисления.
+    size_t reconnects = 0;       ///< Повторные подключения внутри Client::submit().
+};
+
+/**
+ * @brief Показывает справку по параметрам генератора нагрузки.
+ */
+static void ShowHelp()
+{
+    cout << "Usage: loadgen [options]\n"
+         << "Options:\n"
+         << "  -h, --help            Show this help message and exit\n"
+         << "  -a, --address ADDR    Server address (default: 127.0.0.1)\n"
+         << "  -p, --port PORT       Server port (default: 33333)\n"
+         << "  -c, --config PATH     Path to config file (default: ./config/vclient.conf)\n"
+         << "  -j, --sessions N      Concurrent sessions, one thread each (default: 4)\n"
+         << "  -r, --rate N          Target requests per second over all sessions (default: unlimited)\n"
+         << "  -d, --duration SEC    Run time in seconds (default: 10)\n"
+         << "  -n, --vectors N       Vectors per request (default: 100)\n"
+         << "  -l, --length N        Values per vector (default: 64)\n"
+         << "      --session-requests N  Reconnect after N requests (default: keep session)\n"
+         << "      --loopback        Start an in-process stand-in server and load it\n";
+}
+
+/**
+ * @brief Разбирает аргументы командной строки.
+ * 
+ * @param argc Количество аргументов.
+ * @param argv Аргументы.
+ * @return Параметры прогона.
+ * @throws RuntimeError Если параметр неизвестен или задан неверно.
+ */
+static LoadOptions ParseArgs(int argc, char *argv[])
+{
+    LoadOptions options;
+    for (int i = 1; i < argc; ++i)
+    {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+        {
+            ShowHelp();
+            exit(0);
+        }
+        else if (strcmp(argv[i], "--loopback") == 0)
+        {
+            options.loopback = true;
+        }
+        else if (!has_value)
+        {
+            throw RuntimeError("Missing value for parameter " + string(argv[i]), __func__);
+        }
+        else if (strcmp(argv[i], "-a") == 0 || strcmp(argv[i], "--address") == 0)
+            options.address = argv[++i];
+        else if (strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--port") == 0)
+            options.port = stoi(argv[++i]);
+        else if (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--config") == 0)
+            options.config_path = argv[++i];
+        else if (strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--sessions") == 0)
+            options.sessions = stoul(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--rate") == 0)
+            options.rate = stod(argv[++i]);
+        else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--duration") == 0)
+            options.duration = stod(argv[++i]);
+        else if (strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--vectors") == 0)
+            options.vectors = stoul(argv[++i]);
+        else if (strcmp(argv[i], "-l") == 0 || strcmp(argv[i], "--length") == 0)
+            options.length = stoul(argv[++i]);
+        else if (strcmp(argv[i], "--session-requests") == 0)
+            options.session_requests = stoul(argv[++i]);
+        else
+            throw RuntimeError("Unknown parameter: " + string(argv[i]), __func__);
+    }
+
+    if (options.sessions == 0 || options.vectors == 0 || options.duration <= 0 || options.rate < 0)
+    {
+        throw RuntimeError("Sessions, vectors and duration must be positive, rate must not be negative", __func__);
+    }
+    return options;
+}
+
+/**
+ * @brief Формирует синтетический запрос.
+ * 
+ * @param options Параметры прогона.
+ * @param seed Начальное значение генератора.
+ * @return Набор векторов запроса.
+ */
+static VectorBatch GenerateRequest(const LoadOptions &options, uint64_t seed)
+{
+    VectorBatch data;
+    data.reserve(options.vectors, options.vectors * options.length);
+    uint64_t state = seed * 0x9E3779B97F4A7C15ull + 1;
+    for (size_t i = 0; i < options.vectors; ++i)
+    {
+        data.append(options.length);
+        double *values = data.data(i);
+        for (size_t j = 0; j < options.length; ++j)
+        {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            values[j] = double(state >> 11) / double(1ull << 53) - 0.5;
+        }
+    }
+    return data;
+}
+
+/**
+ * @brief Выполняет нагрузку одной сессии до истечения времени прогона.
+ * 
+ * При заданной частоте запросы отправляются по расписанию, а задержка считается
+ * от запланированного момента отправки, чтобы отставание от расписания попадало
+ * в перцентили, а не скрывалось.
+ * 
+ * @param options Параметры прогона.
+ * @param credentials Логин и пароль.
+ * @param index Номер сессии.
+ * @param start Момент начала прогона.
+ * @param result Результаты сессии.
+ */
+static void RunSession(const LoadOptions &options, const array<string, 2> &credentials, size_t index,
+                       chrono::steady_clock::time_point start, LoadResult &result)
+{
+    typedef chrono::steady_clock clock;
+    const clock::time_point deadline = start + chrono::duration_cast<clock::duration>(chrono::duration<double>(options.duration));
+    const VectorBatch data = GenerateRequest(options, index + 1);
+
+    // Сессии сдвинуты по фазе, чтобы не отправлять запросы одновременно
+    clock::duration interval = clock::duration::zero();
+    clock::time_point scheduled = start;
+    if (options.rate > 0)
+    {
+        interval = chrono::duration_cast<clock::duration>(chrono::duration<double>(options.sessions / options.rate));
+        scheduled += interval * index / options.sessions;
+    }
+
+    while (clock::now() < deadline)
+    {
+        Client client(options.address, options.port);
+        Stopwatch watch;
+        try
+        {
+            client.connectToServer();
+            result.connect.add(watch.elapsed());
+        }
+        catch (const RuntimeError &)
+        {
+            ++result.connect_errors;
+            this_thread::sleep_for(chrono::milliseconds(10));
+            continue;
+        }
+
+        watch.restart();
+        try
+        {
+            client.authenticate(credentials[0], credentials[1]);
+            result.auth.add(watch.elapsed());
+        }
+        catch (const RuntimeError &)
+        {
+            ++result.auth_errors;
+            client.closeConnection();
+            this_thread::sleep_for(chrono::milliseconds(10));
+            continue;
+        }
+
+        for (size_t sent = 0; options.session_requests == 0 || sent < options.session_requests; ++sent)
+        {
+            if (options.rate > 0)
+            {
+                this_thread::sleep_until(scheduled);
+            }
+            clock::time_point begin = options.rate > 0 ? scheduled : clock::now();
+            if (begin >= deadline)
+            {
+                break;
+            }
+            scheduled += interval;
+
+            try
+            {
+                client.submit(data, 0, data.size());
+                result.calculate.add(chrono::duration<double>(clock::now() - begin).count());
+            }
+            catch (const RuntimeError &)
+            {
+                ++result.calculate_errors;
+                break;
+            }
+        }
+        result.reconnects += client.getReconnects();
+        client.closeConnection();
+    }
+}
+
+/**
+ * @brief Печатает строку отчёта по фазе.
+ * 
+ * @param name Название фазы.
+ * @param stats Замеры фазы.
+ * @param errors Количество ошибок фазы.
+ */
+static void Report(const string &name, const LatencyStats &stats, size_t errors)
+{
+    cout << left << setw(11) << name << right << setw(10) << stats.count() << setw(8) << errors
+         << setw(12) << FormatDuration(stats.percentile(50))
+         << setw(12) << FormatDuration(stats.percentile(99))
+         << setw(12) << FormatDuration(stats.percentile(99.9))
+         << setw(12) << FormatDuration(stats.percentile(100)) << endl;
+}
+
+/**
+ * @brief Главная функция генератора нагрузки.
+ * 
+ * Запускает заданное количество сессий Client, каждая в своём потоке, отправляет
+ * синтетические запросы с заданной частотой и печатает достигнутую пропускную
+ * способность, количество ошибок и перцентили задержек подключения,
+ * аутентификации и вычисления.
+ * 
+ * @param argc Количество аргументов.
+ * @param argv Аргументы.
+ * @return Код завершения программы.
+ */
+int main(int argc, char *argv[])
+{
+    try
+    {
+        LoadOptions options = ParseArgs(argc, argv);
+
+        unique_ptr<LoopbackServer> server;
+        array<string, 2> credentials;
+        if (options.loopback)
+        {
+            credentials = {"user", "P@ssW0rd"};
+            server.reset(new LoopbackServer(credentials[1]));
+            server->start();
+            options.address = "127.0.0.1";
+            options.port = server->getPort();
+        }
+        else
+        {
+            credentials = DataHandler(options.config_path, "", "").loadConfig();
+        }
+
+        cout << "[LOG] Loading " << options.address << ":" << options.port << " with " << options.sessions
+             << " sessions of " << options.vectors << "x" << options.length << " requests for "
+             << options.duration << " s" << endl;
+
+        vector<LoadResult> results(options.sessions);
+        vector<thread> threads;
+        Stopwatch watch;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (size_t s = 0; s < options.sessions; ++s)
+        {
+            threads.push_back(thread(RunSession, cref(options), cref(credentials), s, start, ref(results[s])));
+        }
+        for (auto &worker : threads)
+        {
+            worker.join();
+        }
+        double elapsed = watch.elapsed();
+
+        LoadResult total;
+        for (const auto &result : results)
+        {
+            total.connect.merge(result.connect);
+            total.auth.merge(result.auth);
+            total.calculate.merge(result.calculate);
+            total.connect_errors += result.connect_errors;
+            total.auth_errors += result.auth_errors;
+            total.calculate_errors += result.calculate_errors;
+            total.reconnects += result.reconnects;
+        }
+
+        cout << left << setw(11) << "phase" << right << setw(10) << "ok" << setw(8) << "errors"
+             << setw(12) << "p50" << setw(12) << "p99" << setw(12) << "p999" << setw(12) << "max" << endl;
+        Report("connect", total.connect, total.connect_errors);
+        Report("auth", total.auth, total.auth_errors);
+        Report("calculate", total.calculate, total.calculate_errors);
+
+        double requests = total.calculate.count() / elapsed;
+        cout << fixed << setprecision(1) << "[LOG] Achieved " << requests << " req/s, "
+             << requests * options.vectors << " vec/s";
+        if (options.rate > 0)
+        {
+            cout << " (target " << options.rate << " req/s)";
+        }
+        cout << ", " << total.reconnects << " silent reconnects" << endl;
+
+        if (server)
+        {
+            server->stop();
+        }
+    }
+    catch (const RuntimeError &e)
+    {
+        cerr << "[ERR] Runtime error: " << e.what() << endl;
+        return 1;
+    }
+    catch (const exception &e)
+    {
+        cerr << "[ERR] Error: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
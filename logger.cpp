@@ -0,0 +1,179 @@
+#include "logger.h"
+
+// Префиксы строк по уровням
+static const char *const LEVEL_PREFIXES[] = {"[ERR] ", "[LOG] ", "[DBG] "};
+
+// Функция для разбора уровня журнала
+LogLevel ParseLogLevel(const string &name)
+{
+    if (name == "quiet")
+        return LogLevel::Error;
+    if (name == "info")
+        return LogLevel::Info;
+    if (name == "debug")
+        return LogLevel::Debug;
+    throw RuntimeError("Unknown log level: " + name, __func__);
+}
+
+// Конструктор
+Logger::Logger(ostream &out, ostream &err, size_t capacity)
+    : out_(out), err_(err), ring_(max<size_t>(capacity, 1)), head_(0), size_(0),
+      writing_(false), stopping_(false), level_(int(LogLevel::Info)), dump_limit_(8)
+{
+    this->writer_ = thread(&Logger::run, this);
+}
+
+Logger::~Logger()
+{
+    {
+        lock_guard<mutex> lock(this->mutex_);
+        this->stopping_ = true;
+    }
+    this->not_empty_.notify_one();
+    this->writer_.join();
+}
+
+// Метод для получения общего журнала
+Logger &Logger::instance()
+{
+    static Logger logger;
+    return logger;
+}
+
+// Методы для настройки журнала
+void Logger::setLevel(LogLevel level)
+{
+    this->level_ = int(level);
+}
+
+bool Logger::enabled(LogLevel level) const
+{
+    return int(level) <= this->level_.load(memory_order_relaxed);
+}
+
+void Logger::setDumpLimit(size_t limit)
+{
+    this->dump_limit_ = limit;
+}
+
+size_t Logger::getDumpLimit() const
+{
+    return this->dump_limit_;
+}
+
+// Метод для помещения сообщения в очередь
+void Logger::write(LogLevel level, string message)
+{
+    if (!enabled(level))
+    {
+        return;
+    }
+
+    unique_lock<mutex> lock(this->mutex_);
+    this->not_full_.wait(lock, [this]() { return this->size_ < this->ring_.size(); });
+    Entry &entry = this->ring_[(this->head_ + this->size_) % this->ring_.size()];
+    entry.level = level;
+    entry.text = move(message);
+    ++this->size_;
+    lock.unlock();
+    this->not_empty_.notify_one();
+}
+
+// Метод для ожидания записи очереди
+void Logger::flush()
+{
+    unique_lock<mutex> lock(this->mutex_);
+    this->drained_.wait(lock, [this]() { return this->size_ == 0 && !this->writing_; });
+}
+
+// Метод потока записи
+void Logger::run()
+{
+    vector<Entry> batch;
+    unique_lock<mutex> lock(this->mutex_);
+    while (true)
+    {
+        this->not_empty_.wait(lock, [this]() { return this->size_ > 0 || this->stopping_; });
+        if (this->size_ == 0)
+        {
+            return;
+        }
+
+        // Забираем всю очередь, чтобы писать без блокировки
+        batch.clear();
+        for (; this->size_ > 0; --this->size_)
+        {
+            batch.push_back(move(this->ring_[this->head_]));
+            this->head_ = (this->head_ + 1) % this->ring_.size();
+        }
+        this->writing_ = true;
+        lock.unlock();
+        this->not_full_.notify_all();
+
+        bool has_output = false;
+        bool has_errors = false;
+        for (const Entry &entry : batch)
+        {
+            if (entry.level == LogLevel::Error)
+            {
+                // Сообщения до ошибки должны появиться раньше неё
+                if (has_output)
+                {
+                    this->out_.flush();
+                    has_output = false;
+                }
+                this->err_ << LEVEL_PREFIXES[int(entry.level)] << entry.text << '\n';
+                has_errors = true;
+            }
+            else
+            {
+                this->out_ << LEVEL_PREFIXES[int(entry.level)] << entry.text << '\n';
+                has_output = true;
+            }
+        }
+        this->out_.flush();
+        if (has_errors)
+        {
+            this->err_.flush();
+        }
+
+        lock.lock();
+        this->writing_ = false;
+        this->drained_.notify_all();
+    }
+}
+
+// Конструктор
+LogLine::LogLine(LogLevel level, Logger &logger)
+    : level_(level), logger_(logger), enabled_(logger.enabled(level)) {}
+
+LogLine::LogLine(LogLine &&other)
+    : level_(other.level_), logger_(other.logger_), enabled_(other.enabled_)
+{
+    this->stream_ << other.stream_.str();
+    other.enabled_ = false;
+}
+
+LogLine::~LogLine()
+{
+    if (this->enabled_)
+    {
+        this->logger_.write(this->level_, this->stream_.str());
+    }
+}
+
+// Функции для начала строк журнала
+LogLine LogInfo()
+{
+    return LogLine(LogLevel::Info);
+}
+
+LogLine LogDebug()
+{
+    return LogLine(LogLevel::Debug);
+}
+
+LogLine LogError()
+{
+    return LogLine(LogLevel::Error);
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "error.h"
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+using namespace std;
+
+/**
+ * @brief Уровень сообщения журнала и порог вывода.
+ *
+ * При пороге Error (режим quiet) выводятся только ошибки.
+ */
+enum class LogLevel
+{
+    Error, ///< Ошибки, выводятся всегда.
+    Info,  ///< Ход выполнения.
+    Debug  ///< Подробности и дампы данных.
+};
+
+/**
+ * @brief Разбирает название уровня журнала.
+ * 
+ * @param name Название: quiet, info или debug.
+ * @return Порог вывода.
+ * @throws RuntimeError Если название неизвестно.
+ */
+LogLevel ParseLogLevel(const string &name);
+
+/**
+ * @class Logger
+ * @brief Асинхронный журнал с кольцевым буфером и фоновым потоком записи.
+ *
+ * Сообщения помещаются в кольцевой буфер фиксированного размера, а фоновый поток
+ * записывает их пачками и сбрасывает поток вывода один раз на пачку. Сообщения
+ * ниже порога отбрасываются до форматирования. При заполненном буфере запись
+ * ожидает освобождения места, поэтому сообщения не теряются.
+ */
+class Logger
+{
+public:
+    /**
+     * @brief Конструктор класса Logger. Запускает поток записи.
+     * 
+     * @param out Поток для сообщений уровней Info и Debug.
+     * @param err Поток для ошибок.
+     * @param capacity Размер кольцевого буфера в сообщениях.
+     */
+    explicit Logger(ostream &out = cout, ostream &err = cerr, size_t capacity = 4096);
+
+    /**
+     * @brief Деструктор класса Logger. Записывает оставшиеся сообщения и останавливает поток.
+     */
+    ~Logger();
+
+    /**
+     * @brief Возвращает общий журнал процесса.
+     * 
+     * @return Журнал.
+     */
+    static Logger &instance();
+
+    /**
+     * @brief Устанавливает порог вывода.
+     * 
+     * @param level Порог вывода.
+     */
+    void setLevel(LogLevel level);
+
+    /**
+     * @brief Проверяет, выводятся ли сообщения уровня.
+     * 
+     * @param level Уровень сообщения.
+     * @return true, если сообщение будет выведено.
+     */
+    bool enabled(LogLevel level) const;
+
+    /**
+     * @brief Устанавливает количество элементов в дампах данных.
+     * 
+     * @param limit Максимальное количество выводимых векторов и значений.
+     */
+    void setDumpLimit(size_t limit);
+
+    /**
+     * @brief Возвращает количество элементов в дампах данных.
+     * 
+     * @return Максимальное количество выводимых векторов и значений.
+     */
+    size_t getDumpLimit() const;
+
+    /**
+     * @brief Помещает сообщение в очередь записи.
+     * 
+     * @param level Уровень сообщения.
+     * @param message Текст сообщения без префикса и перевода строки.
+     */
+    void write(LogLevel level, string message);
+
+    /**
+     * @brief Ожидает записи всех сообщений из очереди.
+     */
+    void flush();
+
+private:
+    /**
+     * @brief Записывает сообщения из очереди, пока журнал не остановлен.
+     */
+    void run();
+
+    /**
+     * @brief Сообщение в очереди.
+     */
+    struct Entry
+    {
+        LogLevel level; ///< Уровень сообщения.
+        string text;    ///< Текст сообщения.
+    };
+
+    ostream &out_;                 ///< Поток для сообщений.
+    ostream &err_;                 ///< Поток для ошибок.
+    vector<Entry> ring_;           ///< Кольцевой буфер сообщений.
+    size_t head_;                  ///< Индекс первого сообщения.
+    size_t size_;                  ///< Количество сообщений в буфере.
+    bool writing_;                 ///< Поток записи выводит пачку.
+    bool stopping_;                ///< Журнал останавливается.
+    atomic<int> level_;            ///< Порог вывода.
+    atomic<size_t> dump_limit_;    ///< Количество элементов в дампах.
+    mutex mutex_;                  ///< Мьютекс буфера.
+    condition_variable not_empty_; ///< Сигнал о новых сообщениях.
+    condition_variable not_full_;  ///< Сигнал об освобождении места.
+    condition_variable drained_;   ///< Сигнал о записи всех сообщений.
+    thread writer_;                ///< Поток записи.
+};
+
+/**
+ * @class LogLine
+ * @brief Строка журнала, собираемая оператором << и отправляемая при уничтожении.
+ *
+ * Если уровень строки ниже порога, аргументы не форматируются.
+ */
+class LogLine
+{
+public:
+    /**
+     * @brief Конструктор класса LogLine.
+     * 
+     * @param level Уровень сообщения.
+     * @param logger Журнал, в который отправляется строка.
+     */
+    explicit LogLine(LogLevel level, Logger &logger = Logger::instance());
+
+    /**
+     * @brief Конструктор перемещения.
+     * 
+     * @param other Перемещаемая строка.
+     */
+    LogLine(LogLine &&other);
+
+    /**
+     * @brief Деструктор класса LogLine. Отправляет строку в журнал.
+     */
+    ~LogLine();
+
+    /**
+     * @brief Добавляет значение к строке.
+     * 
+     * @param value Значение.
+     * @return Эта же строка.
+     */
+    template <typename T>
+    LogLine &operator<<(const T &value)
+    {
+        if (this->enabled_)
+        {
+            this->stream_ << value;
+        }
+        return *this;
+    }
+
+private:
+    LogLevel level_;       ///< Уровень сообщения.
+    Logger &logger_;       ///< Журнал.
+    bool enabled_;         ///< Будет ли строка выведена.
+    ostringstream stream_; ///< Текст строки.
+};
+
+/**
+ * @brief Начинает строку журнала уровня Info.
+ * 
+ * @return Строка журнала.
+ */
+LogLine LogInfo();
+
+/**
+ * @brief Начинает строку журнала уровня Debug.
+ * 
+ * @return Строка журнала.
+ */
+LogLine LogDebug();
+
+/**
+ * @brief Начинает строку журнала уровня Error.
+ * 
+ * @return Строка журнала.
+ */
+LogLine LogError();
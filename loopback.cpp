@@ -0,0 +1,302 @@
+#include "loopback.h"
+#include "client.h"
+#include "reader.h"
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+// Соль, которую сервер отправляет клиенту
+static const char LOOPBACK_SALT[] = "0123456789ABCDEF";
+
+// Функция для отправки буфера целиком
+static bool SendAll(int socket, const void *data, size_t size)
+{
+    const char *bytes = static_cast<const char *>(data);
+    while (size > 0)
+    {
+        ssize_t sent = send(socket, bytes, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (sent <= 0)
+        {
+            return false;
+        }
+        bytes += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+// Функция для преобразования значений типа T в double
+template <typename T>
+static void DecodeAs(const char *bytes, double *values, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        T value;
+        memcpy(&value, bytes + i * sizeof(T), sizeof(T));
+        values[i] = double(value);
+    }
+}
+
+// Функция для преобразования double в значение типа T
+template <typename T>
+static void EncodeAs(double value, char *bytes)
+{
+    T converted = T(value);
+    memcpy(bytes, &converted, sizeof(T));
+}
+
+// Функция для преобразования значений заданного типа в double
+static void DecodeValues(ElementType type, const char *bytes, double *values, size_t count)
+{
+    switch (type)
+    {
+    case ElementType::Int16:
+        DecodeAs<int16_t>(bytes, values, count);
+        break;
+    case ElementType::Int32:
+        DecodeAs<int32_t>(bytes, values, count);
+        break;
+    case ElementType::Int64:
+        DecodeAs<int64_t>(bytes, values, count);
+        break;
+    case ElementType::Float:
+        DecodeAs<float>(bytes, values, count);
+        break;
+    case ElementType::Double:
+        DecodeAs<double>(bytes, values, count);
+        break;
+    }
+}
+
+// Функция для преобразования double в значение заданного типа
+static void EncodeValue(ElementType type, double value, char *bytes)
+{
+    switch (type)
+    {
+    case ElementType::Int16:
+        EncodeAs<int16_t>(value, bytes);
+        break;
+    case ElementType::Int32:
+        EncodeAs<int32_t>(value, bytes);
+        break;
+    case ElementType::Int64:
+        EncodeAs<int64_t>(value, bytes);
+        break;
+    case ElementType::Float:
+        EncodeAs<float>(value, bytes);
+        break;
+    case ElementType::Double:
+        EncodeAs<double>(value, bytes);
+        break;
+    }
+}
+
+// Конструктор
+LoopbackServer::LoopbackServer(const string &password, Reduction reduction, bool single_request)
+    : password_(password), engine_(reduction, Kernel::Scalar), single_request_(single_request),
+      element_type_(ElementType::Double), listen_socket_(-1), port_(0), running_(false), connections_(0), requests_(0) {}
+
+LoopbackServer::~LoopbackServer()
+{
+    stop();
+}
+
+// Метод для запуска сервера
+void LoopbackServer::start()
+{
+    this->listen_socket_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (this->listen_socket_ < 0)
+    {
+        throw RuntimeError("Failed to create socket", __func__);
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t addr_len = sizeof(addr);
+    if (bind(this->listen_socket_, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(this->listen_socket_, 128) < 0 ||
+        getsockname(this->listen_socket_, (struct sockaddr *)&addr, &addr_len) < 0)
+    {
+        ::close(this->listen_socket_);
+        this->listen_socket_ = -1;
+        throw RuntimeError("Failed to listen on loopback", __func__);
+    }
+
+    this->port_ = ntohs(addr.sin_port);
+    this->running_ = true;
+    this->acceptor_ = thread(&LoopbackServer::acceptLoop, this);
+}
+
+// Метод для остановки сервера
+void LoopbackServer::stop()
+{
+    if (!this->running_.exchange(false))
+    {
+        return;
+    }
+
+    // Разблокируем accept() и recv() во всех потоках
+    ::shutdown(this->listen_socket_, SHUT_RDWR);
+    this->acceptor_.join();
+    ::close(this->listen_socket_);
+    this->listen_socket_ = -1;
+
+    vector<thread> workers;
+    {
+        lock_guard<mutex> lock(this->mutex_);
+        for (int socket : this->sockets_)
+        {
+            ::shutdown(socket, SHUT_RDWR);
+        }
+        workers.swap(this->workers_);
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    for (int socket : this->sockets_)
+    {
+        ::close(socket);
+    }
+    this->sockets_.clear();
+}
+
+uint16_t LoopbackServer::getPort() const
+{
+    return this->port_;
+}
+
+size_t LoopbackServer::getConnections() const
+{
+    return this->connections_;
+}
+
+size_t LoopbackServer::getRequests() const
+{
+    return this->requests_;
+}
+
+void LoopbackServer::setElementType(ElementType type)
+{
+    this->element_type_ = type;
+}
+
+// Метод для приёма соединений
+void LoopbackServer::acceptLoop()
+{
+    while (this->running_)
+    {
+        int socket = accept(this->listen_socket_, nullptr, nullptr);
+        if (socket < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return;
+        }
+
+        lock_guard<mutex> lock(this->mutex_);
+        ++this->connections_;
+        this->sockets_.push_back(socket);
+        this->workers_.push_back(thread(&LoopbackServer::serve, this, socket));
+    }
+}
+
+// Метод для обслуживания соединения
+void LoopbackServer::serve(int socket)
+{
+    try
+    {
+        // Логин приходит одним сообщением без длины
+        char login[256];
+        if (recv(socket, login, sizeof(login), 0) <= 0 ||
+            !SendAll(socket, LOOPBACK_SALT, sizeof(LOOPBACK_SALT) - 1))
+        {
+            ::shutdown(socket, SHUT_RDWR);
+            return;
+        }
+
+        SocketReader reader;
+        reader.reset(socket);
+        string expected = Client::digest(LOOPBACK_SALT, this->password_);
+        string hash(expected.size(), '\0');
+        reader.readExact(&hash[0], hash.size(), "hash");
+        if (hash != expected)
+        {
+            SendAll(socket, "ERR", 3);
+            ::shutdown(socket, SHUT_RDWR);
+            return;
+        }
+        SendAll(socket, "OK", 2);
+
+        const size_t element_size = ElementSize(this->element_type_);
+        vector<double> vec;
+        vector<double> results;
+        vector<char> raw;
+        while (true)
+        {
+            uint32_t num_vectors;
+            reader.readExact(&num_vectors, sizeof(num_vectors), "number of vectors");
+
+            // Результаты запроса отправляются одним блоком после чтения всех векторов
+            results.resize(num_vectors);
+            for (uint32_t i = 0; i < num_vectors; ++i)
+            {
+                uint32_t vec_size;
+                reader.readExact(&vec_size, sizeof(vec_size), "vector size");
+                vec.resize(vec_size);
+                if (this->element_type_ == ElementType::Double)
+                {
+                    reader.readExact(vec.data(), vec_size * sizeof(double), "vector data");
+                }
+                else
+                {
+                    raw.resize(vec_size * element_size);
+                    reader.readExact(raw.data(), raw.size(), "vector data");
+                    DecodeValues(this->element_type_, raw.data(), vec.data(), vec_size);
+                }
+                results[i] = this->engine_.reduce(vec.data(), vec_size);
+            }
+
+            bool sent;
+            if (this->element_type_ == ElementType::Double)
+            {
+                sent = SendAll(socket, results.data(), results.size() * sizeof(double));
+            }
+            else
+            {
+                raw.resize(results.size() * element_size);
+                for (size_t i = 0; i < results.size(); ++i)
+                {
+                    EncodeValue(this->element_type_, results[i], raw.data() + i * element_size);
+                }
+                sent = SendAll(socket, raw.data(), raw.size());
+            }
+            if (!sent)
+            {
+                break;
+            }
+
+            ++this->requests_;
+            if (this->single_request_)
+            {
+                break;
+            }
+        }
+    }
+    catch (const RuntimeError &)
+    {
+        // Клиент закрыл соединение
+    }
+    ::shutdown(socket, SHUT_RDWR);
+}
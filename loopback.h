@@ -0,0 +1,111 @@
+#pragma once
+
+#include "error.h"
+#include "engine.h"
+#include "data.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @class LoopbackServer
+ * @brief Локальный заменитель сервера вычислений для тестов и замеров.
+ *
+ * Слушает случайный порт на 127.0.0.1 и реализует тот же протокол, что и сервер:
+ * логин, соль, MD5-хеш, ответ "OK", затем запросы из количества векторов и
+ * векторов с размерами, на каждый из которых возвращается свёртка LocalEngine.
+ * Каждое соединение обслуживается в отдельном потоке.
+ */
+class LoopbackServer
+{
+public:
+    /**
+     * @brief Конструктор класса LoopbackServer.
+     * 
+     * @param password Пароль, который должен подтвердить клиент.
+     * @param reduction Операция свёртки векторов.
+     * @param single_request Закрывать соединение после первого запроса.
+     */
+    explicit LoopbackServer(const string &password = "P@ssW0rd", Reduction reduction = Reduction::Sum,
+                            bool single_request = false);
+
+    /**
+     * @brief Деструктор класса LoopbackServer. Останавливает сервер.
+     */
+    ~LoopbackServer();
+
+    /**
+     * @brief Запускает сервер.
+     * 
+     * @throws RuntimeError Если не удалось открыть слушающий сокет.
+     */
+    void start();
+
+    /**
+     * @brief Останавливает сервер и закрывает все соединения.
+     */
+    void stop();
+
+    /**
+     * @brief Возвращает порт, на котором слушает сервер.
+     * 
+     * @return Порт сервера.
+     */
+    uint16_t getPort() const;
+
+    /**
+     * @brief Возвращает количество принятых соединений.
+     * 
+     * @return Количество соединений.
+     */
+    size_t getConnections() const;
+
+    /**
+     * @brief Возвращает количество обработанных запросов.
+     * 
+     * @return Количество запросов.
+     */
+    size_t getRequests() const;
+
+    /**
+     * @brief Задаёт тип элементов векторов и результатов, как ключ -T сервера.
+     * 
+     * Значения преобразуются в double для свёртки, а результат - обратно в заданный тип.
+     * Вызывается до start().
+     * 
+     * @param type Тип элементов (по умолчанию double).
+     */
+    void setElementType(ElementType type);
+
+private:
+    /**
+     * @brief Принимает соединения, пока сервер запущен.
+     */
+    void acceptLoop();
+
+    /**
+     * @brief Обслуживает одно соединение.
+     * 
+     * @param socket Сокет соединения.
+     */
+    void serve(int socket);
+
+    string password_;            ///< Ожидаемый пароль.
+    LocalEngine engine_;         ///< Вычислитель свёрток.
+    bool single_request_;        ///< Закрывать соединение после первого запроса.
+    ElementType element_type_;   ///< Тип элементов векторов и результатов.
+    int listen_socket_;          ///< Слушающий сокет.
+    uint16_t port_;              ///< Порт сервера.
+    atomic<bool> running_;       ///< Запущен ли сервер.
+    atomic<size_t> connections_; ///< Количество принятых соединений.
+    atomic<size_t> requests_;    ///< Количество обработанных запросов.
+    thread acceptor_;            ///< Поток приёма соединений.
+    vector<thread> workers_;     ///< Потоки обслуживания соединений.
+    vector<int> sockets_;        ///< Сокеты соединений.
+    mutex mutex_;                ///< Мьютекс списков потоков и сокетов.
+};
@@ -2,11 +2,195 @@
 #include "data.h"
 #include "client.h"
 #include "terminal.h"
+#include "pipeline.h"
+#include "pool.h"
+#include "dispatch.h"
+#include "engine.h"
+#include "cache.h"
+#include "dedup.h"
+#include "checkpoint.h"
+#include "validate.h"
+#include "metrics.h"
+#include "logger.h"
 #include <array>
+#include <memory>
+#include <functional>
 #include <iostream>
 
 using namespace std;
 
+// Код возврата при истечении срока фазы или всего запуска (как у timeout(1))
+static const int EXIT_TIMEOUT = 124;
+
+/**
+ * @brief Сверяет результаты сервера с локальными вычислениями.
+ * 
+ * @param engine Локальный вычислитель.
+ * @param vectors Входные векторы.
+ * @param result Результаты сервера.
+ * @throws RuntimeError Если результаты не совпадают.
+ */
+static void VerifyResults(const LocalEngine &engine, const VectorBatch &vectors, const vector<double> &result)
+{
+    size_t mismatches = CountMismatches(engine.calculate(vectors), result);
+    if (mismatches > 0)
+    {
+        throw RuntimeError(to_string(mismatches) + " of " + to_string(result.size()) + " server results differ from local calculation", __func__);
+    }
+    LogInfo() << "Server results match local calculation";
+}
+
+/**
+ * @brief Выводит вектор в журнал с ограничением длины дампа.
+ * 
+ * @param title Заголовок дампа.
+ * @param data Вектор данных.
+ */
+template <typename T>
+static void DumpVector(const string &title, const vector<T> &data)
+{
+    if (Logger::instance().enabled(LogLevel::Info))
+    {
+        LogInfo() << title << "\n" << FormatVector(data, Logger::instance().getDumpLimit());
+    }
+}
+
+/**
+ * @brief Выводит векторы в журнал с ограничением длины дампа.
+ * 
+ * @param title Заголовок дампа.
+ * @param data Векторы данных.
+ */
+template <typename T>
+static void DumpVectors(const string &title, const BasicVectorBatch<T> &data)
+{
+    if (Logger::instance().enabled(LogLevel::Info))
+    {
+        LogInfo() << title << "\n" << FormatVectors(data, Logger::instance().getDumpLimit());
+    }
+}
+
+/**
+ * @brief Проверяет загруженные векторы до отправки на сервер.
+ * 
+ * @param terminal Параметры командной строки.
+ * @param vectors Входные векторы.
+ * @param type Тип элементов, в котором векторы передаются серверу.
+ * @throws RuntimeError Если векторы содержат NaN, бесконечности или значения, сумма которых может переполнить тип.
+ */
+template <typename T>
+static void ValidateInput(const Terminal &terminal, const BasicVectorBatch<T> &vectors, ElementType type)
+{
+    InputValidator validator(ParseKernel(terminal.getKernel()));
+    ValidationReport report = validator.validate(vectors);
+    if (Logger::instance().enabled(LogLevel::Info))
+    {
+        LogInfo() << "Input statistics (" << validator.getKernelName() << " kernel):\n"
+                  << FormatStats(report, Logger::instance().getDumpLimit());
+    }
+    CheckValidation(report, type);
+}
+
+/**
+ * @brief Выполняет чтение, вычисление и запись для векторов с элементами типа T.
+ * 
+ * Используется для типов, отличных от double: одна сессия, все векторы в памяти.
+ * 
+ * @param terminal Параметры командной строки.
+ * @param data Обработчик входного и выходного файлов.
+ * @param userpass Логин и пароль.
+ * @param deadline Срок завершения запуска.
+ * @throws RuntimeError Если не удалось выполнить вычисления.
+ */
+template <typename T>
+static void RunTyped(const Terminal &terminal, const DataHandler &data, const array<string, 2> &userpass, const Deadline &deadline)
+{
+    // Подключаемся к серверу и аутентифицируем пользователя
+    LogInfo() << "Connecting to server at " << terminal.getAddress() << ":" << terminal.getPort() << "...";
+    Client client(terminal.getAddress(), terminal.getPort());
+    client.setBatchLimit(terminal.getSendBatch());
+    client.setSocketOptions(terminal.getSocketOptions());
+    client.setIoBackend(ParseIoBackend(terminal.getIoBackend()));
+    client.setJobDeadline(deadline);
+    client.connectToServer();
+    LogInfo() << "Authenticating user " << userpass[0] << "...";
+    client.authenticate(userpass[0], userpass[1]);
+
+    // Читаем данные, выполняем вычисления и записываем результаты
+    LogInfo() << "Reading data from " << terminal.getInputPath() << "...";
+    BasicVectorBatch<T> vectors = Timed("read", [&]() { return data.template readData<T>(terminal.getThreads()); });
+    Timed("print", [&]() { DumpVectors("Read data:", vectors); });
+    if (terminal.isValidate())
+    {
+        Timed("validate", [&]() { ValidateInput(terminal, vectors, ParseElementType(terminal.getElementType())); });
+    }
+
+    LogInfo() << "Calculating results...";
+    vector<T> result = Timed("calculate", [&]() { return client.submit(vectors, 0, vectors.size()); });
+    client.closeConnection();
+    Timed("print", [&]() { DumpVector("Calculated results:", result); });
+
+    LogInfo() << "Writing results to " << terminal.getOutputPath() << "...";
+    Timed("write", [&]() { data.writeData(result); });
+}
+
+/**
+ * @brief Выбирает специализацию RunTyped() по типу элементов, заданному при запуске.
+ * 
+ * @param type Тип элементов.
+ * @param terminal Параметры командной строки.
+ * @param data Обработчик входного и выходного файлов.
+ * @param userpass Логин и пароль.
+ * @param deadline Срок завершения запуска.
+ */
+static void RunWithElementType(ElementType type, const Terminal &terminal, const DataHandler &data, const array<string, 2> &userpass,
+                               const Deadline &deadline)
+{
+    switch (type)
+    {
+    case ElementType::Int16:
+        RunTyped<int16_t>(terminal, data, userpass, deadline);
+        break;
+    case ElementType::Int32:
+        RunTyped<int32_t>(terminal, data, userpass, deadline);
+        break;
+    case ElementType::Int64:
+        RunTyped<int64_t>(terminal, data, userpass, deadline);
+        break;
+    case ElementType::Float:
+        RunTyped<float>(terminal, data, userpass, deadline);
+        break;
+    case ElementType::Double:
+        RunTyped<double>(terminal, data, userpass, deadline);
+        break;
+    }
+}
+
+/**
+ * @brief Сохраняет метрики при любом выходе из main(), в том числе по ошибке.
+ */
+struct MetricsExport
+{
+    string path;   ///< Путь к файлу метрик.
+    string format; ///< Формат файла метрик.
+
+    ~MetricsExport()
+    {
+        if (this->path.empty())
+        {
+            return;
+        }
+        try
+        {
+            Metrics::instance().save(this->path, this->format);
+        }
+        catch (const exception &e)
+        {
+            LogError() << "" << e.what();
+        }
+    }
+};
+
 /**
  * @brief Главная функция программы.
  * 
@@ -20,71 +204,345 @@ using namespace std;
  * - Выполняет вычисления.
  * - Записывает результаты в выходной файл.
  * 
+ * В потоковом режиме три последних шага выполняются одновременно по частям,
+ * а при нескольких сессиях или серверах векторы распределяются между ними.
+ * В пакетном режиме шаги чтения, вычисления и записи повторяются для каждого
+ * задания из списка в одной аутентифицированной сессии.
+ * В локальном режиме вычисления выполняются без подключения к серверу.
+ * Для типов элементов, отличных от double, используется RunTyped().
+ * 
  * @param argc Количество аргументов командной строки.
  * @param argv Массив аргументов командной строки.
- * @return int Код возврата программы.
+ * @return int Код возврата программы: 0 при успехе, EXIT_TIMEOUT при истечении срока, 1 при прочих ошибках.
  */
 int main(int argc, char *argv[])
 {
+    MetricsExport metrics;
     try
     {
-        // Логируем инициализацию терминала
-        cout << "[LOG] Initializing Terminal..." << endl;
+        // Инициализируем терминал и журнал: уровень журнала известен только после разбора аргументов
         Terminal terminal;
         terminal.parseArgs(argc, argv);
+        Deadline deadline = terminal.getDeadline() > 0 ? Deadline(chrono::milliseconds(terminal.getDeadline())) : Deadline();
+        Logger::instance().setLevel(ParseLogLevel(terminal.getLogLevel()));
+        Logger::instance().setDumpLimit(terminal.isDump() ? SIZE_MAX : 8);
+        LogInfo() << "Initialized Terminal";
+        metrics.path = terminal.getMetricsPath();
+        metrics.format = terminal.getMetricsFormat();
 
         // Логируем пути и параметры конфигурации
-        cout << "[LOG] Config Path: " << terminal.getConfigPath() << endl;
-        cout << "[LOG] Input Path: " << terminal.getInputPath() << endl;
-        cout << "[LOG] Output Path: " << terminal.getOutputPath() << endl;
-        cout << "[LOG] Server Address: " << terminal.getAddress() << endl;
-        cout << "[LOG] Server Port: " << terminal.getPort() << endl;
-
-        // Подключаемся к серверу
-        cout << "[LOG] Connecting to server at " << terminal.getAddress() << ":" << terminal.getPort() << "..." << endl;
-        Client client(terminal.getAddress(), terminal.getPort());
-        client.connectToServer();
-
-        // Загружаем конфигурацию
-        cout << "[LOG] Loading configuration from " << terminal.getConfigPath() << "..." << endl;
+        LogInfo() << "Config Path: " << terminal.getConfigPath();
+        LogInfo() << "Input Path: " << terminal.getInputPath();
+        LogInfo() << "Output Path: " << terminal.getOutputPath();
+        LogInfo() << "Server Address: " << terminal.getAddress();
+        LogInfo() << "Server Port: " << terminal.getPort();
+
         DataHandler data(terminal.getConfigPath(), terminal.getInputPath(), terminal.getOutputPath());
 
-        // Получаем логин и пароль из конфигурационного файла
-        array<string, 2> userpass = data.loadConfig();
-        cout << "[LOG] Username: " << userpass[0] << endl;
+        // Выбираем способ ввода-вывода
+        IoBackend io_backend = ParseIoBackend(terminal.getIoBackend());
+        if (io_backend == IoBackend::Uring && !IoRing::isSupported())
+        {
+            LogInfo() << "io_uring is not available, falling back to blocking I/O";
+        }
+        data.setIoBackend(io_backend);
+
+        // Готовим локальный вычислитель для локального режима или сверки
+        unique_ptr<LocalEngine> engine;
+        if (terminal.isLocal() || terminal.isVerify())
+        {
+            engine.reset(new LocalEngine(ParseReduction(terminal.getReduction()), ParseKernel(terminal.getKernel())));
+            LogInfo() << "Local engine: " << terminal.getReduction() << " using " << engine->getKernelName() << " kernel";
+        }
+
+        array<string, 2> userpass;
+        if (!terminal.isLocal())
+        {
+            // Загружаем конфигурацию
+            LogInfo() << "Loading configuration from " << terminal.getConfigPath() << "...";
+
+            // Получаем логин и пароль из конфигурационного файла
+            userpass = data.loadConfig();
+            LogInfo() << "Username: " << userpass[0];
+        }
+
+        ElementType element_type = ParseElementType(terminal.getElementType());
+        if (element_type != ElementType::Double)
+        {
+            // Передаём значения в типе, заданном серверу
+            LogInfo() << "Element type: " << ElementTypeName(element_type);
+            RunWithElementType(element_type, terminal, data, userpass, deadline);
+            LogInfo() << "Operation completed successfully!";
+            return 0;
+        }
+
+        if (!terminal.getManifestPath().empty())
+        {
+            // Выполняем все задания из списка в одной сессии
+            vector<Job> jobs = LoadManifest(terminal.getManifestPath());
+            LogInfo() << "Loaded " << jobs.size() << " jobs from " << terminal.getManifestPath();
+
+            LogInfo() << "Connecting to server at " << terminal.getAddress() << ":" << terminal.getPort() << "...";
+            Client client(terminal.getAddress(), terminal.getPort());
+            client.setBatchLimit(terminal.getSendBatch());
+            client.setSocketOptions(terminal.getSocketOptions());
+            client.setIoBackend(io_backend);
+            client.setJobDeadline(deadline);
+            client.connectToServer();
+            client.authenticate(userpass[0], userpass[1]);
+
+            size_t failed = 0;
+            for (const Job &job : jobs)
+            {
+                DataHandler job_data(terminal.getConfigPath(), job.input_path, job.output_path);
+                job_data.setIoBackend(io_backend);
+                try
+                {
+                    VectorBatch vectors = Timed("read", [&]() { return job_data.readData(terminal.getThreads()); });
+                    if (terminal.isValidate())
+                    {
+                        Timed("validate", [&]() { ValidateInput(terminal, vectors, ElementType::Double); });
+                    }
+                    try
+                    {
+                        if (!client.isConnected())
+                        {
+                            client.reconnect();
+                        }
+                        vector<double> result = Timed("calculate", [&]() { return client.submit(vectors, 0, vectors.size()); });
+                        Timed("write", [&]() { job_data.writeData(result); });
+                    }
+                    catch (const RuntimeError &)
+                    {
+                        // Состояние сессии неизвестно: следующее задание начнёт с переподключения
+                        client.closeConnection();
+                        throw;
+                    }
+                    LogInfo() << "Job " << job.input_path << " -> " << job.output_path << ": " << vectors.size() << " vectors";
+                }
+                catch (const exception &e)
+                {
+                    // По истечении срока запуска остальные задания не выполняются, запуск завершается как по таймауту
+                    if (deadline.expired())
+                    {
+                        throw TimeoutError("Job deadline expired during job " + job.input_path + " -> " + job.output_path + ": " + e.what(), __func__);
+                    }
+                    ++failed;
+                    Metrics::instance().count(Counter::Errors);
+                    LogError() << "Job " << job.input_path << " -> " << job.output_path << " failed: " << e.what();
+                }
+            }
+            client.closeConnection();
+
+            LogInfo() << "Completed " << jobs.size() - failed << " of " << jobs.size() << " jobs, reconnects: " << client.getReconnects();
+            return failed == 0 ? 0 : 1;
+        }
+
+        // Выбираем способ вычислений для векторов, загруженных в память
+        unique_ptr<Client> client;
+        unique_ptr<ClientPool> pool;
+        unique_ptr<Dispatcher> dispatcher;
+        unique_ptr<Checkpoint> checkpoint;
+        function<vector<double>(const VectorBatch &)> calculate;
+        if (terminal.isLocal())
+        {
+            calculate = [&](const VectorBatch &vectors) { return engine->calculate(vectors); };
+        }
+        else if (terminal.getEndpoints().size() > 1)
+        {
+            // Распределяем векторы между несколькими серверами
+            vector<Endpoint> endpoints = terminal.getEndpoints();
+            LogInfo() << "Connecting to " << endpoints.size() << " servers...";
+            dispatcher.reset(new Dispatcher(endpoints));
+            dispatcher->setSocketOptions(terminal.getSocketOptions());
+            dispatcher->setJobDeadline(deadline);
+            size_t alive = dispatcher->connect(userpass[0], userpass[1]);
+            LogInfo() << "Available servers: " << alive;
+            calculate = [&](const VectorBatch &vectors) { return dispatcher->calculate(vectors, terminal.getChunkSize()); };
+        }
+        else if (terminal.getSessions() > 1)
+        {
+            // Открываем несколько сессий и распределяем между ними векторы
+            LogInfo() << "Opening " << terminal.getSessions() << " sessions to " << terminal.getAddress() << ":" << terminal.getPort() << "...";
+            pool.reset(new ClientPool(terminal.getAddress(), terminal.getPort(), terminal.getSessions()));
+            pool->setBatchLimit(terminal.getSendBatch());
+            pool->setSocketOptions(terminal.getSocketOptions());
+            pool->setJobDeadline(deadline);
+            pool->connect(userpass[0], userpass[1]);
+            calculate = [&](const VectorBatch &vectors) { return pool->calculate(vectors, terminal.getChunkSize()); };
+        }
+        else
+        {
+            // Подключаемся к серверу
+            LogInfo() << "Connecting to server at " << terminal.getAddress() << ":" << terminal.getPort() << "...";
+            client.reset(new Client(terminal.getAddress(), terminal.getPort()));
+            client->setBatchLimit(terminal.getSendBatch());
+            client->setSocketOptions(terminal.getSocketOptions());
+            client->setIoBackend(io_backend);
+            client->setJobDeadline(deadline);
+            client->connectToServer();
 
-        // Аутентифицируем пользователя на сервере
-        cout << "[LOG] Authenticating user " << userpass[0] << "..." << endl;
-        client.authenticate(userpass[0], userpass[1]);
+            // Аутентифицируем пользователя на сервере
+            LogInfo() << "Authenticating user " << userpass[0] << "...";
+            client->authenticate(userpass[0], userpass[1]);
+
+            if (terminal.isStreaming())
+            {
+                // Читаем, передаём и записываем данные по частям
+                LogInfo() << "Streaming " << terminal.getInputPath() << " to " << terminal.getOutputPath()
+                          << " in chunks of " << terminal.getChunkSize() << " vectors...";
+                DataReader reader(terminal.getInputPath());
+                DataWriter writer(terminal.getOutputPath(), reader.getCount());
+                Pipeline pipeline(*client, terminal.getChunkSize());
+                uint32_t processed = Timed("stream", [&]() { return pipeline.run(reader, writer); });
+                LogInfo() << "Processed " << processed << " vectors";
+
+                LogInfo() << "Operation completed successfully!";
+                return 0;
+            }
+
+            if (terminal.isZeroCopy())
+            {
+                // Проверяем структуру входного файла и передаём его без разбора
+                LogInfo() << "Validating input file " << terminal.getInputPath() << "...";
+                uint32_t num_vectors = Timed("read", [&]() { return data.scanData(); });
+                LogInfo() << "Input file contains " << num_vectors << " vectors";
+
+                LogInfo() << "Sending input file to server...";
+                vector<double> result = Timed("calculate", [&]() { return client->calculateFile(terminal.getInputPath(), num_vectors); });
+                Timed("print", [&]() { DumpVector("Calculated results:", result); });
+
+                LogInfo() << "Writing results to " << terminal.getOutputPath() << "...";
+                Timed("write", [&]() { data.writeData(result); });
+
+                LogInfo() << "Operation completed successfully!";
+                return 0;
+            }
+
+            if (terminal.isCheckpoint())
+            {
+                // Передаём векторы частями и сохраняем результаты каждой части
+                calculate = [&](const VectorBatch &vectors) {
+                    string checkpoint_path = terminal.getOutputPath() + ".ckpt";
+                    checkpoint.reset(new Checkpoint(checkpoint_path, vectors));
+                    size_t completed = checkpoint->load();
+                    if (completed > 0)
+                    {
+                        LogInfo() << "Resuming from " << checkpoint_path << ": " << completed << " of " << vectors.size()
+                                  << " vectors already calculated";
+                    }
+                    return CalculateResumable(*client, vectors, *checkpoint, terminal.getChunkSize(), terminal.getRetries());
+                };
+            }
+            else if (terminal.getWindow() > 1)
+            {
+                // Держим несколько частей в полёте, перекрывая задержку сети
+                LogInfo() << "Pipelining requests of " << terminal.getChunkSize() << " vectors, window " << terminal.getWindow();
+                calculate = [&](const VectorBatch &vectors) {
+                    return client->calculateWindowed(vectors, terminal.getChunkSize(), terminal.getWindow());
+                };
+            }
+            else
+            {
+                calculate = [&](const VectorBatch &vectors) { return client->calculate(vectors); };
+            }
+        }
 
         // Читаем данные из входного файла
-        cout << "[LOG] Reading data from " << terminal.getInputPath() << "..." << endl;
-        vector<vector<double>> vectors = data.readData();
-        cout << "[LOG] Read data: " << endl;
-        PrintVectors(vectors);
+        LogInfo() << "Reading data from " << terminal.getInputPath() << "...";
+        VectorBatch vectors = Timed("read", [&]() { return data.readData(terminal.getThreads()); });
+        Timed("print", [&]() { DumpVectors("Read data:", vectors); });
+        if (terminal.isValidate())
+        {
+            Timed("validate", [&]() { ValidateInput(terminal, vectors, ElementType::Double); });
+        }
 
         // Выполняем вычисления
-        cout << "[LOG] Calculating results..." << endl;
-        vector<double> result = client.calculate(vectors);
-        cout << "[LOG] Calculated results: " << endl;
-        PrintVector(result);
+        LogInfo() << "Calculating results" << (terminal.isLocal() ? " locally" : "") << "...";
+        if (terminal.isDedup())
+        {
+            // Передаём каждый уникальный вектор один раз
+            function<vector<double>(const VectorBatch &)> send_unique = calculate;
+            calculate = [send_unique](const VectorBatch &vectors) {
+                Deduplicator dedup(vectors);
+                LogInfo() << "Dedup: " << dedup.getUniqueCount() << " unique of " << dedup.getTotalCount()
+                          << " vectors, ratio " << dedup.getRatio();
+                return dedup.expand(send_unique(dedup.unique()));
+            };
+        }
+
+        vector<double> result;
+        {
+            PhaseTimer timer("calculate");
+            if (!terminal.getCachePath().empty())
+            {
+                // Отправляем только векторы, отсутствующие в кэше
+                string tag = terminal.isLocal() ? "local/" + terminal.getReduction() : "double/MD5";
+                ResultCache cache(terminal.getCachePath(), tag);
+                size_t loaded = cache.load();
+                size_t hits = 0;
+                result = CalculateCached(cache, vectors, calculate, hits);
+                cache.save();
+                LogInfo() << "Cache " << terminal.getCachePath() << ": " << loaded << " entries, "
+                          << hits << " of " << vectors.size() << " vectors found";
+            }
+            else
+            {
+                result = calculate(vectors);
+            }
+        }
+        if (terminal.isVerify())
+        {
+            Timed("verify", [&]() { VerifyResults(*engine, vectors, result); });
+        }
+        if (pool)
+        {
+            pool->closeConnections();
+            LogInfo() << "Chunks stolen between sessions: " << pool->getStolen();
+        }
+        if (dispatcher)
+        {
+            dispatcher->closeConnections();
+            for (const ServerStats &stats : dispatcher->getStats())
+            {
+                LogInfo() << "Server " << stats.endpoint.address << ":" << stats.endpoint.port
+                          << ": " << stats.vectors << " vectors, " << stats.failures << " failures, "
+                          << stats.latency * 1e6 << " us per vector";
+            }
+        }
+        Timed("print", [&]() { DumpVector("Calculated results:", result); });
 
         // Записываем результаты в выходной файл
-        cout << "[LOG] Writing results to " << terminal.getOutputPath() << "..." << endl;
-        data.writeData(result);
+        LogInfo() << "Writing results to " << terminal.getOutputPath() << "...";
+        Timed("write", [&]() { data.writeData(result); });
+        if (checkpoint)
+        {
+            // Результаты записаны, контрольная точка больше не нужна
+            checkpoint->remove();
+            LogInfo() << "Reconnects: " << client->getReconnects();
+        }
 
-        cout << "[LOG] Operation completed successfully!" << endl;
+        LogInfo() << "Operation completed successfully!";
+    }
+    catch (const TimeoutError &e)
+    {
+        // Истёкший срок отличается кодом возврата от прочих ошибок
+        Metrics::instance().count(Counter::Errors);
+        LogError() << "Timeout: " << e.what();
+        return EXIT_TIMEOUT;
     }
     catch (const RuntimeError &e)
     {
         // Логируем ошибки времени выполнения
-        cerr << "[ERR] Runtime error: " << e.what() << endl;
+        Metrics::instance().count(Counter::Errors);
+        LogError() << "Runtime error: " << e.what();
         return 1;
     }
     catch (const exception &e)
     {
         // Логируем общие ошибки
-        cerr << "[ERR] Error: " << e.what() << endl;
+        Metrics::instance().count(Counter::Errors);
+        LogError() << "Error: " << e.what();
         return 1;
     }
 
@@ -0,0 +1,192 @@
+#include "metrics.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <sys/resource.h>
+
+// Имена счётчиков для экспорта
+static const char *const COUNTER_NAMES[] = {
+    "bytes_sent", "bytes_received", "send_calls", "recv_calls", "poll_calls", "connects", "read_calls",
+    "bytes_read", "ring_enters", "errors"};
+
+// Конструктор
+Metrics::Metrics()
+    : start_(chrono::steady_clock::now())
+{
+    for (auto &counter : this->counters_)
+    {
+        counter = 0;
+    }
+}
+
+// Метод для получения общего набора метрик
+Metrics &Metrics::instance()
+{
+    static Metrics metrics;
+    return metrics;
+}
+
+// Метод для добавления длительности фазы
+void Metrics::addPhase(const string &phase, double seconds)
+{
+    lock_guard<mutex> lock(this->phases_mutex_);
+    for (auto &item : this->phases_)
+    {
+        if (item.name == phase)
+        {
+            item.seconds += seconds;
+            ++item.calls;
+            return;
+        }
+    }
+    this->phases_.push_back({phase, seconds, 1});
+}
+
+// Методы для работы со счётчиками
+void Metrics::count(Counter counter, uint64_t value)
+{
+    this->counters_[size_t(counter)].fetch_add(value, memory_order_relaxed);
+}
+
+uint64_t Metrics::get(Counter counter) const
+{
+    return this->counters_[size_t(counter)].load(memory_order_relaxed);
+}
+
+// Методы для получения времени фаз
+double Metrics::getPhaseTime(const string &phase) const
+{
+    lock_guard<mutex> lock(this->phases_mutex_);
+    for (const auto &item : this->phases_)
+    {
+        if (item.name == phase)
+        {
+            return item.seconds;
+        }
+    }
+    return 0.0;
+}
+
+size_t Metrics::getPhaseCalls(const string &phase) const
+{
+    lock_guard<mutex> lock(this->phases_mutex_);
+    for (const auto &item : this->phases_)
+    {
+        if (item.name == phase)
+        {
+            return item.calls;
+        }
+    }
+    return 0;
+}
+
+// Метод для получения использования ресурсов
+ResourceUsage Metrics::getResourceUsage()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) < 0)
+    {
+        return {0, 0.0, 0.0};
+    }
+    // В Linux ru_maxrss измеряется в килобайтах
+    return {uint64_t(usage.ru_maxrss) * 1024,
+            usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6,
+            usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6};
+}
+
+// Метод для формирования JSON
+string Metrics::toJson() const
+{
+    ResourceUsage usage = getResourceUsage();
+    double wall = chrono::duration<double>(chrono::steady_clock::now() - this->start_).count();
+
+    ostringstream out;
+    out << setprecision(9);
+    out << "{\n  \"wall_seconds\": " << wall << ",\n  \"phases\": {";
+    {
+        lock_guard<mutex> lock(this->phases_mutex_);
+        for (size_t i = 0; i < this->phases_.size(); ++i)
+        {
+            out << (i ? ",\n" : "\n") << "    \"" << this->phases_[i].name << "\": {\"seconds\": "
+                << this->phases_[i].seconds << ", \"calls\": " << this->phases_[i].calls << "}";
+        }
+    }
+    out << "\n  },\n  \"counters\": {";
+    for (size_t i = 0; i < size_t(Counter::Count); ++i)
+    {
+        out << (i ? ",\n" : "\n") << "    \"" << COUNTER_NAMES[i] << "\": " << get(Counter(i));
+    }
+    out << "\n  },\n  \"peak_rss_bytes\": " << usage.peak_rss
+        << ",\n  \"user_cpu_seconds\": " << usage.user_cpu
+        << ",\n  \"system_cpu_seconds\": " << usage.system_cpu << "\n}\n";
+    return out.str();
+}
+
+// Метод для формирования текста Prometheus
+string Metrics::toPrometheus() const
+{
+    ResourceUsage usage = getResourceUsage();
+    double wall = chrono::duration<double>(chrono::steady_clock::now() - this->start_).count();
+
+    ostringstream out;
+    out << setprecision(9);
+    out << "# HELP vclient_phase_seconds_total Time spent in each phase, summed over threads.\n"
+        << "# TYPE vclient_phase_seconds_total counter\n";
+    {
+        lock_guard<mutex> lock(this->phases_mutex_);
+        for (const auto &item : this->phases_)
+        {
+            out << "vclient_phase_seconds_total{phase=\"" << item.name << "\"} " << item.seconds << "\n";
+        }
+        out << "# HELP vclient_phase_calls_total Number of times each phase ran.\n"
+            << "# TYPE vclient_phase_calls_total counter\n";
+        for (const auto &item : this->phases_)
+        {
+            out << "vclient_phase_calls_total{phase=\"" << item.name << "\"} " << item.calls << "\n";
+        }
+    }
+    for (size_t i = 0; i < size_t(Counter::Count); ++i)
+    {
+        out << "# TYPE vclient_" << COUNTER_NAMES[i] << "_total counter\n"
+            << "vclient_" << COUNTER_NAMES[i] << "_total " << get(Counter(i)) << "\n";
+    }
+    out << "# TYPE vclient_wall_seconds gauge\nvclient_wall_seconds " << wall << "\n"
+        << "# TYPE vclient_peak_rss_bytes gauge\nvclient_peak_rss_bytes " << usage.peak_rss << "\n"
+        << "# TYPE vclient_user_cpu_seconds_total counter\nvclient_user_cpu_seconds_total " << usage.user_cpu << "\n"
+        << "# TYPE vclient_system_cpu_seconds_total counter\nvclient_system_cpu_seconds_total " << usage.system_cpu << "\n";
+    return out.str();
+}
+
+// Метод для сохранения метрик в файл
+void Metrics::save(const string &path, const string &format) const
+{
+    string text;
+    if (format == "json")
+    {
+        text = toJson();
+    }
+    else if (format == "prometheus")
+    {
+        text = toPrometheus();
+    }
+    else
+    {
+        throw RuntimeError("Unknown metrics format: " + format, __func__);
+    }
+
+    ofstream file(path);
+    file << text;
+    if (!file)
+    {
+        throw RuntimeError("Failed to write metrics file \"" + path + "\"", __func__);
+    }
+}
+
+// Конструктор
+PhaseTimer::PhaseTimer(const string &phase, Metrics &metrics)
+    : phase_(phase), metrics_(metrics), start_(chrono::steady_clock::now()) {}
+
+PhaseTimer::~PhaseTimer()
+{
+    this->metrics_.addPhase(this->phase_, chrono::duration<double>(chrono::steady_clock::now() - this->start_).count());
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "error.h"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @brief Счётчики событий ввода-вывода.
+ */
+enum class Counter
+{
+    BytesSent,     ///< Байт передано в сокеты.
+    BytesReceived, ///< Байт принято из сокетов.
+    SendCalls,     ///< Вызовов send(), sendmsg() и sendfile().
+    RecvCalls,     ///< Вызовов recv().
+    PollCalls,     ///< Вызовов epoll_wait() и poll().
+    Connects,      ///< Вызовов connect().
+    ReadCalls,     ///< Вызовов pread() и операций чтения io_uring при загрузке входного файла.
+    BytesRead,     ///< Байт прочитано из входного файла.
+    RingEnters,    ///< Вызовов io_uring_enter().
+    Errors,        ///< Ошибок выполнения и неудачных заданий.
+    Count          ///< Количество счётчиков.
+};
+
+/**
+ * @brief Снимок использования ресурсов процессом.
+ */
+struct ResourceUsage
+{
+    uint64_t peak_rss; ///< Пиковый размер резидентной памяти в байтах.
+    double user_cpu;   ///< Процессорное время в режиме пользователя, с.
+    double system_cpu; ///< Процессорное время в режиме ядра, с.
+};
+
+/**
+ * @class Metrics
+ * @brief Класс для накопления времени фаз и счётчиков ввода-вывода.
+ *
+ * Время фазы суммируется по всем вызовам и всем потокам, поэтому при нескольких
+ * сессиях оно может превышать общее время работы. Счётчики атомарны и дёшевы,
+ * их можно увеличивать на каждом системном вызове.
+ */
+class Metrics
+{
+public:
+    /**
+     * @brief Конструктор класса Metrics. Запоминает момент запуска.
+     */
+    Metrics();
+
+    /**
+     * @brief Возвращает общий набор метрик процесса.
+     * 
+     * @return Набор метрик.
+     */
+    static Metrics &instance();
+
+    /**
+     * @brief Добавляет длительность одного вызова фазы.
+     * 
+     * @param phase Название фазы.
+     * @param seconds Длительность в секундах.
+     */
+    void addPhase(const string &phase, double seconds);
+
+    /**
+     * @brief Увеличивает счётчик.
+     * 
+     * @param counter Счётчик.
+     * @param value Величина увеличения.
+     */
+    void count(Counter counter, uint64_t value = 1);
+
+    /**
+     * @brief Возвращает значение счётчика.
+     * 
+     * @param counter Счётчик.
+     * @return Значение счётчика.
+     */
+    uint64_t get(Counter counter) const;
+
+    /**
+     * @brief Возвращает суммарное время фазы.
+     * 
+     * @param phase Название фазы.
+     * @return Время в секундах (0, если фаза не выполнялась).
+     */
+    double getPhaseTime(const string &phase) const;
+
+    /**
+     * @brief Возвращает количество вызовов фазы.
+     * 
+     * @param phase Название фазы.
+     * @return Количество вызовов.
+     */
+    size_t getPhaseCalls(const string &phase) const;
+
+    /**
+     * @brief Возвращает использование ресурсов процессом.
+     * 
+     * @return Пиковая память и процессорное время по getrusage().
+     */
+    static ResourceUsage getResourceUsage();
+
+    /**
+     * @brief Формирует метрики в формате JSON.
+     * 
+     * @return Текст JSON.
+     */
+    string toJson() const;
+
+    /**
+     * @brief Формирует метрики в текстовом формате Prometheus.
+     * 
+     * @return Текст в формате Prometheus.
+     */
+    string toPrometheus() const;
+
+    /**
+     * @brief Сохраняет метрики в файл.
+     * 
+     * @param path Путь к файлу.
+     * @param format Формат: "json" или "prometheus".
+     * @throws RuntimeError Если формат неизвестен или файл не удалось записать.
+     */
+    void save(const string &path, const string &format) const;
+
+private:
+    /**
+     * @brief Накопленное время одной фазы.
+     */
+    struct Phase
+    {
+        string name;    ///< Название фазы.
+        double seconds; ///< Суммарное время, с.
+        size_t calls;   ///< Количество вызовов.
+    };
+
+    chrono::steady_clock::time_point start_;            ///< Момент запуска.
+    vector<Phase> phases_;                              ///< Фазы в порядке первого вызова.
+    mutable mutex phases_mutex_;                        ///< Мьютекс списка фаз.
+    atomic<uint64_t> counters_[size_t(Counter::Count)]; ///< Значения счётчиков.
+};
+
+/**
+ * @class PhaseTimer
+ * @brief Класс для замера фазы от создания до уничтожения объекта.
+ */
+class PhaseTimer
+{
+public:
+    /**
+     * @brief Конструктор класса PhaseTimer. Запускает замер.
+     * 
+     * @param phase Название фазы.
+     * @param metrics Набор метрик, в который добавляется замер.
+     */
+    explicit PhaseTimer(const string &phase, Metrics &metrics = Metrics::instance());
+
+    /**
+     * @brief Деструктор класса PhaseTimer. Добавляет длительность фазы в метрики.
+     */
+    ~PhaseTimer();
+
+private:
+    string phase_;                           ///< Название фазы.
+    Metrics &metrics_;                       ///< Набор метрик.
+    chrono::steady_clock::time_point start_; ///< Момент начала фазы.
+};
+
+/**
+ * @brief Выполняет действие с замером времени фазы.
+ * 
+ * @param phase Название фазы.
+ * @param action Действие.
+ * @return Результат действия.
+ */
+template <typename Action>
+auto Timed(const string &phase, Action action) -> decltype(action())
+{
+    PhaseTimer timer(phase);
+    return action();
+}
@@ -0,0 +1,148 @@
+#include "pipeline.h"
+#include <thread>
+#include <exception>
+#include <algorithm>
+
+// Конструктор очереди
+ChunkQueue::ChunkQueue(size_t capacity)
+    : capacity_(capacity), closed_(false), cancelled_(false) {}
+
+bool ChunkQueue::push(VectorBatch &&chunk)
+{
+    unique_lock<mutex> lock(mutex_);
+    changed_.wait(lock, [this]() { return cancelled_ || chunks_.size() < capacity_; });
+    if (cancelled_)
+    {
+        return false;
+    }
+
+    chunks_.push_back(move(chunk));
+    changed_.notify_all();
+    return true;
+}
+
+bool ChunkQueue::pop(VectorBatch &chunk)
+{
+    unique_lock<mutex> lock(mutex_);
+    changed_.wait(lock, [this]() { return cancelled_ || closed_ || !chunks_.empty(); });
+    if (cancelled_ || chunks_.empty())
+    {
+        return false;
+    }
+
+    chunk = move(chunks_.front());
+    chunks_.pop_front();
+    changed_.notify_all();
+    return true;
+}
+
+void ChunkQueue::close()
+{
+    lock_guard<mutex> lock(mutex_);
+    closed_ = true;
+    changed_.notify_all();
+}
+
+void ChunkQueue::cancel()
+{
+    lock_guard<mutex> lock(mutex_);
+    cancelled_ = true;
+    chunks_.clear();
+    changed_.notify_all();
+}
+
+// Конструктор конвейера
+Pipeline::Pipeline(Client &client, size_t chunk_size, size_t queue_depth)
+    : client_(client), chunk_size_(chunk_size), queue_depth_(queue_depth) {}
+
+// Метод для обработки всего входного файла
+uint32_t Pipeline::run(DataReader &reader, DataWriter &writer)
+{
+    const uint32_t num_vectors = reader.getCount();
+    ChunkQueue queue(this->queue_depth_);
+    this->client_.beginPhase();
+    exception_ptr reader_error, sender_error, receiver_error;
+
+    // Ошибка в любом потоке останавливает остальные
+    auto abort = [&]() {
+        queue.cancel();
+        this->client_.interrupt();
+    };
+
+    // Поток чтения входного файла
+    thread reader_thread([&]() {
+        try
+        {
+            VectorBatch chunk;
+            while (reader.readChunk(chunk, this->chunk_size_) > 0)
+            {
+                if (!queue.push(move(chunk)))
+                {
+                    return;
+                }
+                chunk = VectorBatch();
+            }
+            queue.close();
+        }
+        catch (...)
+        {
+            reader_error = current_exception();
+            abort();
+        }
+    });
+
+    // Поток отправки векторов
+    thread sender_thread([&]() {
+        try
+        {
+            this->client_.sendCount(num_vectors);
+            VectorBatch chunk;
+            while (queue.pop(chunk))
+            {
+                this->client_.sendVectors(chunk);
+            }
+        }
+        catch (...)
+        {
+            sender_error = current_exception();
+            abort();
+        }
+    });
+
+    // Получение результатов и запись их в выходной файл
+    try
+    {
+        uint32_t received = 0;
+        while (received < num_vectors)
+        {
+            uint32_t count = min<uint32_t>(this->chunk_size_, num_vectors - received);
+            writer.append(this->client_.receiveResults(count));
+            received += count;
+        }
+        writer.close();
+    }
+    catch (...)
+    {
+        receiver_error = current_exception();
+        abort();
+    }
+
+    reader_thread.join();
+    sender_thread.join();
+
+    // Первопричиной считается ошибка на более раннем этапе
+    if (reader_error)
+    {
+        rethrow_exception(reader_error);
+    }
+    if (sender_error)
+    {
+        rethrow_exception(sender_error);
+    }
+    if (receiver_error)
+    {
+        rethrow_exception(receiver_error);
+    }
+
+    return num_vectors;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "error.h"
+#include "data.h"
+#include "client.h"
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+/**
+ * @class ChunkQueue
+ * @brief Ограниченная очередь частей входных данных между потоками конвейера.
+ */
+class ChunkQueue
+{
+public:
+    /**
+     * @brief Конструктор класса ChunkQueue.
+     * 
+     * @param capacity Максимальное количество частей в очереди.
+     */
+    explicit ChunkQueue(size_t capacity);
+
+    /**
+     * @brief Помещает часть в очередь, ожидая свободного места.
+     * 
+     * @param chunk Часть входных данных.
+     * @return false, если очередь отменена.
+     */
+    bool push(VectorBatch &&chunk);
+
+    /**
+     * @brief Извлекает часть из очереди, ожидая её появления.
+     * 
+     * @param chunk Извлечённая часть.
+     * @return false, если очередь закрыта и пуста или отменена.
+     */
+    bool pop(VectorBatch &chunk);
+
+    /**
+     * @brief Закрывает очередь: новых частей не будет, оставшиеся можно извлечь.
+     */
+    void close();
+
+    /**
+     * @brief Отменяет очередь: оставшиеся части отбрасываются, ожидающие потоки разблокируются.
+     */
+    void cancel();
+
+private:
+    deque<VectorBatch> chunks_;  ///< Части, ожидающие отправки.
+    size_t capacity_;            ///< Максимальное количество частей.
+    bool closed_;                ///< Признак закрытия очереди.
+    bool cancelled_;             ///< Признак отмены очереди.
+    mutex mutex_;                ///< Мьютекс очереди.
+    condition_variable changed_; ///< Уведомление об изменении очереди.
+};
+
+/**
+ * @class Pipeline
+ * @brief Класс потоковой обработки данных с ограниченным расходом памяти.
+ *
+ * Чтение входного файла, отправка векторов, получение результатов и их запись
+ * выполняются одновременно в трёх потоках. В памяти одновременно находится
+ * лишь несколько частей входных данных.
+ */
+class Pipeline
+{
+public:
+    /**
+     * @brief Конструктор класса Pipeline.
+     * 
+     * @param client Клиент с установленным и аутентифицированным соединением.
+     * @param chunk_size Количество векторов в одной части.
+     * @param queue_depth Максимальное количество прочитанных, но ещё не отправленных частей.
+     */
+    Pipeline(Client &client, size_t chunk_size, size_t queue_depth = 2);
+
+    /**
+     * @brief Выполняет обработку всего входного файла.
+     * 
+     * @param reader Источник входных данных.
+     * @param writer Приёмник результатов.
+     * @return Количество обработанных векторов.
+     * @throws RuntimeError Если произошла ошибка чтения, передачи или записи данных.
+     */
+    uint32_t run(DataReader &reader, DataWriter &writer);
+
+private:
+    Client &client_;     ///< Клиент для передачи данных.
+    size_t chunk_size_;  ///< Количество векторов в одной части.
+    size_t queue_depth_; ///< Глубина очереди между чтением и отправкой.
+};
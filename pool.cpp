@@ -0,0 +1,174 @@
+#include "pool.h"
+#include <thread>
+#include <exception>
+#include <algorithm>
+
+// Конструктор
+ClientPool::ClientPool(const string &address, uint16_t port, size_t sessions)
+    : stolen_(0)
+{
+    if (sessions == 0)
+    {
+        throw RuntimeError("Number of sessions must be positive", __func__);
+    }
+
+    for (size_t i = 0; i < sessions; ++i)
+    {
+        this->clients_.push_back(unique_ptr<Client>(new Client(address, port)));
+    }
+}
+
+void ClientPool::setBatchLimit(size_t batch_limit)
+{
+    for (auto &client : this->clients_)
+    {
+        client->setBatchLimit(batch_limit);
+    }
+}
+
+void ClientPool::setSocketOptions(const SocketOptions &options)
+{
+    for (auto &client : this->clients_)
+    {
+        client->setSocketOptions(options);
+    }
+}
+
+void ClientPool::setJobDeadline(const Deadline &deadline)
+{
+    for (auto &client : this->clients_)
+    {
+        client->setJobDeadline(deadline);
+    }
+}
+
+// Метод для подключения всех сессий
+void ClientPool::connect(const string &username, const string &password)
+{
+    for (auto &client : this->clients_)
+    {
+        client->connectToServer();
+        client->authenticate(username, password);
+    }
+}
+
+// Метод для распределённых вычислений
+vector<double> ClientPool::calculate(const VectorBatch &data, size_t chunk_size)
+{
+    const size_t sessions = this->clients_.size();
+    chunk_size = max<size_t>(1, chunk_size);
+    this->stolen_ = 0;
+
+    // Части раздаются сессиям непрерывными блоками, чтобы перехват шёл с конца чужого блока
+    vector<WorkQueue> queues(sessions);
+    const size_t num_chunks = (data.size() + chunk_size - 1) / chunk_size;
+    for (size_t chunk = 0; chunk < num_chunks; ++chunk)
+    {
+        size_t begin = chunk * chunk_size;
+        size_t end = min(data.size(), begin + chunk_size);
+        queues[chunk * sessions / num_chunks].ranges.push_back(make_pair(begin, end));
+    }
+
+    vector<double> results(data.size());
+    vector<exception_ptr> errors(sessions);
+    atomic<bool> failed(false);
+
+    vector<thread> workers;
+    for (size_t session = 0; session < sessions; ++session)
+    {
+        workers.push_back(thread([&, session]() {
+            try
+            {
+                pair<size_t, size_t> range;
+                while (!failed && takeWork(queues, session, range))
+                {
+                    vector<double> chunk_results = this->clients_[session]->submit(data, range.first, range.second);
+                    copy(chunk_results.begin(), chunk_results.end(), results.begin() + range.first);
+                }
+            }
+            catch (...)
+            {
+                errors[session] = current_exception();
+                failed = true;
+            }
+        }));
+    }
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    for (const auto &error : errors)
+    {
+        if (error)
+        {
+            rethrow_exception(error);
+        }
+    }
+
+    return results;
+}
+
+// Метод для выбора очередной части
+bool ClientPool::takeWork(vector<WorkQueue> &queues, size_t self, pair<size_t, size_t> &range)
+{
+    {
+        lock_guard<mutex> guard(queues[self].lock);
+        if (!queues[self].ranges.empty())
+        {
+            range = queues[self].ranges.front();
+            queues[self].ranges.pop_front();
+            return true;
+        }
+    }
+
+    // Собственная очередь пуста: перехватываем работу у самой загруженной сессии
+    while (true)
+    {
+        size_t victim = self;
+        size_t longest = 0;
+        for (size_t i = 0; i < queues.size(); ++i)
+        {
+            lock_guard<mutex> guard(queues[i].lock);
+            if (queues[i].ranges.size() > longest)
+            {
+                longest = queues[i].ranges.size();
+                victim = i;
+            }
+        }
+
+        if (longest == 0)
+        {
+            return false;
+        }
+
+        lock_guard<mutex> guard(queues[victim].lock);
+        if (!queues[victim].ranges.empty())
+        {
+            range = queues[victim].ranges.back();
+            queues[victim].ranges.pop_back();
+            ++this->stolen_;
+            return true;
+        }
+    }
+}
+
+// Метод для закрытия всех сессий
+void ClientPool::closeConnections()
+{
+    for (auto &client : this->clients_)
+    {
+        client->closeConnection();
+    }
+}
+
+size_t ClientPool::size() const
+{
+    return this->clients_.size();
+}
+
+size_t ClientPool::getStolen() const
+{
+    return this->stolen_;
+}
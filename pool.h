@@ -0,0 +1,121 @@
+#pragma once
+
+#include "error.h"
+#include "client.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <atomic>
+
+using namespace std;
+
+/**
+ * @class ClientPool
+ * @brief Класс для параллельных вычислений в нескольких сессиях с сервером.
+ *
+ * Открывает несколько аутентифицированных соединений, делит входные векторы
+ * на части и распределяет их между сессиями. Каждая сессия обрабатывает
+ * свою очередь частей, а освободившись, забирает части из конца очереди
+ * наиболее загруженной сессии. Результаты собираются в исходном порядке.
+ * Сессия, соединение которой сервер закрыл после предыдущего запроса,
+ * переподключается (см. Client::submit()).
+ */
+class ClientPool
+{
+public:
+    /**
+     * @brief Конструктор класса ClientPool.
+     * 
+     * @param address Адрес сервера.
+     * @param port Порт сервера.
+     * @param sessions Количество сессий.
+     */
+    ClientPool(const string &address, uint16_t port, size_t sessions);
+
+    /**
+     * @brief Устанавливает максимальное количество фрагментов в одном вызове sendmsg() для всех сессий.
+     * 
+     * @param batch_limit Максимальное количество фрагментов в пакете.
+     */
+    void setBatchLimit(size_t batch_limit);
+
+    /**
+     * @brief Устанавливает параметры сокета для всех сессий.
+     * 
+     * @param options Параметры сокета.
+     */
+    void setSocketOptions(const SocketOptions &options);
+
+    /**
+     * @brief Устанавливает срок завершения задания для всех сессий.
+     * 
+     * @param deadline Срок задания.
+     */
+    void setJobDeadline(const Deadline &deadline);
+
+    /**
+     * @brief Открывает и аутентифицирует все сессии.
+     * 
+     * @param username Имя пользователя.
+     * @param password Пароль пользователя.
+     * @throws RuntimeError Если не удалось подключиться или аутентифицироваться.
+     */
+    void connect(const string &username, const string &password);
+
+    /**
+     * @brief Выполняет вычисления, распределяя векторы между сессиями.
+     * 
+     * @param data Данные для вычислений в виде вектора векторов.
+     * @param chunk_size Количество векторов в одной части.
+     * @return Результаты вычислений в исходном порядке векторов.
+     * @throws RuntimeError Если часть не удалось обработать даже после переподключения.
+     */
+    vector<double> calculate(const VectorBatch &data, size_t chunk_size);
+
+    /**
+     * @brief Закрывает все сессии.
+     */
+    void closeConnections();
+
+    /**
+     * @brief Возвращает количество сессий.
+     * 
+     * @return Количество сессий.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Возвращает количество частей, перехваченных у других сессий при последнем вычислении.
+     * 
+     * @return Количество перехваченных частей.
+     */
+    size_t getStolen() const;
+
+private:
+    /**
+     * @brief Очередь частей одной сессии.
+     */
+    struct WorkQueue
+    {
+        deque<pair<size_t, size_t>> ranges; ///< Диапазоны индексов векторов [начало, конец).
+        mutex lock;                         ///< Мьютекс очереди.
+    };
+
+    /**
+     * @brief Выбирает очередную часть для сессии.
+     * 
+     * Берёт часть из начала собственной очереди, а если она пуста,
+     * из конца самой длинной чужой очереди.
+     * 
+     * @param queues Очереди всех сессий.
+     * @param self Номер сессии.
+     * @param range Выбранный диапазон индексов векторов.
+     * @return false, если работы не осталось.
+     */
+    bool takeWork(vector<WorkQueue> &queues, size_t self, pair<size_t, size_t> &range);
+
+    vector<unique_ptr<Client>> clients_; ///< Клиенты сессий.
+    atomic<size_t> stolen_;              ///< Количество перехваченных частей.
+};
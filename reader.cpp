@@ -0,0 +1,84 @@
+#include "reader.h"
+#include "metrics.h"
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <poll.h>
+
+// Конструктор
+SocketReader::SocketReader(size_t capacity)
+    : socket_(-1), buffer_(capacity), begin_(0), end_(0) {}
+
+void SocketReader::reset(int socket)
+{
+    this->socket_ = socket;
+    this->begin_ = 0;
+    this->end_ = 0;
+}
+
+size_t SocketReader::buffered() const
+{
+    return this->end_ - this->begin_;
+}
+
+// Метод для чтения фрагмента точной длины
+void SocketReader::readExact(void *dest, size_t size, const string &what, const Deadline &deadline)
+{
+    char *out = static_cast<char *>(dest);
+
+    // Сначала выдаём то, что уже есть в буфере
+    size_t taken = min(size, buffered());
+    memcpy(out, buffer_.data() + begin_, taken);
+    begin_ += taken;
+    out += taken;
+    size -= taken;
+
+    while (size > 0)
+    {
+        // Крупные фрагменты читаются сразу в буфер назначения
+        if (size >= buffer_.size())
+        {
+            size_t received = receive(out, size, what, deadline);
+            out += received;
+            size -= received;
+            continue;
+        }
+
+        begin_ = 0;
+        end_ = receive(buffer_.data(), buffer_.size(), what, deadline);
+        taken = min(size, end_);
+        memcpy(out, buffer_.data(), taken);
+        begin_ = taken;
+        out += taken;
+        size -= taken;
+    }
+}
+
+// Метод для одного вызова recv()
+size_t SocketReader::receive(void *dest, size_t size, const string &what, const Deadline &deadline)
+{
+    while (true)
+    {
+        ssize_t received = recv(this->socket_, dest, size, 0);
+        Metrics::instance().count(Counter::RecvCalls);
+        if (received > 0)
+        {
+            Metrics::instance().count(Counter::BytesReceived, received);
+            return received;
+        }
+        if (received == 0)
+        {
+            throw RuntimeError("Connection closed while receiving " + what, __func__);
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            WaitSocket(this->socket_, POLLIN, deadline, "receive " + what);
+        }
+        else if (errno != EINTR)
+        {
+            throw RuntimeError("Failed to receive " + what, __func__);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "error.h"
+#include "deadline.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * @class SocketReader
+ * @brief Класс буферизованного чтения из сокета.
+ *
+ * Читает данные из сокета крупными блоками и выдаёт их фрагментами точно
+ * заданной длины, корректно обрабатывая частичные чтения. Неблокирующий сокет
+ * ожидается через poll() не дольше заданного срока.
+ */
+class SocketReader
+{
+public:
+    /**
+     * @brief Конструктор класса SocketReader.
+     * 
+     * @param capacity Размер внутреннего буфера в байтах.
+     */
+    explicit SocketReader(size_t capacity = 64 * 1024);
+
+    /**
+     * @brief Привязывает читатель к сокету и очищает буфер.
+     * 
+     * @param socket Дескриптор сокета.
+     */
+    void reset(int socket);
+
+    /**
+     * @brief Читает ровно size байт.
+     * 
+     * @param dest Буфер назначения.
+     * @param size Количество байт.
+     * @param what Описание читаемых данных для сообщения об ошибке.
+     * @param deadline Срок получения данных.
+     * @throws TimeoutError Если данные не получены до истечения срока.
+     * @throws RuntimeError Если произошла ошибка чтения или соединение закрыто раньше времени.
+     */
+    void readExact(void *dest, size_t size, const string &what, const Deadline &deadline = Deadline());
+
+    /**
+     * @brief Возвращает количество прочитанных из сокета, но ещё не выданных байт.
+     * 
+     * @return Количество байт в буфере.
+     */
+    size_t buffered() const;
+
+private:
+    /**
+     * @brief Выполняет один вызов recv().
+     * 
+     * @param dest Буфер назначения.
+     * @param size Размер буфера.
+     * @param what Описание читаемых данных для сообщения об ошибке.
+     * @param deadline Срок получения данных.
+     * @return Количество прочитанных байт.
+     * @throws TimeoutError Если данные не получены до истечения срока.
+     * @throws RuntimeError Если произошла ошибка чтения или соединение закрыто.
+     */
+    size_t receive(void *dest, size_t size, const string &what, const Deadline &deadline);
+
+    int socket_;          ///< Сокет, из которого выполняется чтение.
+    vector<char> buffer_; ///< Внутренний буфер.
+    size_t begin_;        ///< Начало невыданных данных в буфере.
+    size_t end_;          ///< Конец прочитанных данных в буфере.
+};
@@ -0,0 +1,80 @@
+#include "stats.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+
+// Методы для накопления замеров
+void LatencyStats::add(double seconds)
+{
+    this->samples_.push_back(seconds);
+    this->sorted_ = false;
+}
+
+void LatencyStats::merge(const LatencyStats &other)
+{
+    this->samples_.insert(this->samples_.end(), other.samples_.begin(), other.samples_.end());
+    this->sorted_ = false;
+}
+
+// Метод для расчёта перцентиля по ближайшему рангу
+double LatencyStats::percentile(double p) const
+{
+    if (this->samples_.empty())
+    {
+        return 0.0;
+    }
+    if (!this->sorted_)
+    {
+        sort(this->samples_.begin(), this->samples_.end());
+        this->sorted_ = true;
+    }
+
+    size_t rank = static_cast<size_t>(ceil(p / 100.0 * this->samples_.size()));
+    rank = min(max<size_t>(rank, 1), this->samples_.size());
+    return this->samples_[rank - 1];
+}
+
+double LatencyStats::mean() const
+{
+    return this->samples_.empty() ? 0.0 : total() / this->samples_.size();
+}
+
+double LatencyStats::total() const
+{
+    return accumulate(this->samples_.begin(), this->samples_.end(), 0.0);
+}
+
+size_t LatencyStats::count() const
+{
+    return this->samples_.size();
+}
+
+// Методы секундомера
+Stopwatch::Stopwatch()
+    : start_(chrono::steady_clock::now()) {}
+
+void Stopwatch::restart()
+{
+    this->start_ = chrono::steady_clock::now();
+}
+
+double Stopwatch::elapsed() const
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - this->start_).count();
+}
+
+// Функция для форматирования длительности
+string FormatDuration(double seconds)
+{
+    ostringstream out;
+    out << fixed << setprecision(1);
+    if (seconds < 1e-3)
+        out << seconds * 1e6 << " us";
+    else if (seconds < 1.0)
+        out << seconds * 1e3 << " ms";
+    else
+        out << seconds << " s";
+    return out.str();
+}
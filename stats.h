@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <chrono>
+
+using namespace std;
+
+/**
+ * @class LatencyStats
+ * @brief Класс для накопления замеров времени и расчёта перцентилей.
+ */
+class LatencyStats
+{
+public:
+    /**
+     * @brief Добавляет замер.
+     * 
+     * @param seconds Длительность в секундах.
+     */
+    void add(double seconds);
+
+    /**
+     * @brief Добавляет все замеры другого набора.
+     * 
+     * @param other Другой набор замеров.
+     */
+    void merge(const LatencyStats &other);
+
+    /**
+     * @brief Возвращает перцентиль длительности.
+     * 
+     * @param p Перцентиль от 0 до 100.
+     * @return Длительность в секундах (0, если замеров нет).
+     */
+    double percentile(double p) const;
+
+    /**
+     * @brief Возвращает среднюю длительность.
+     * 
+     * @return Средняя длительность в секундах (0, если замеров нет).
+     */
+    double mean() const;
+
+    /**
+     * @brief Возвращает суммарную длительность.
+     * 
+     * @return Сумма всех замеров в секундах.
+     */
+    double total() const;
+
+    /**
+     * @brief Возвращает количество замеров.
+     * 
+     * @return Количество замеров.
+     */
+    size_t count() const;
+
+private:
+    mutable vector<double> samples_; ///< Замеры в секундах.
+    mutable bool sorted_ = true;     ///< Упорядочены ли замеры.
+};
+
+/**
+ * @class Stopwatch
+ * @brief Класс для замера времени по монотонным часам.
+ */
+class Stopwatch
+{
+public:
+    /**
+     * @brief Конструктор класса Stopwatch. Запускает отсчёт.
+     */
+    Stopwatch();
+
+    /**
+     * @brief Перезапускает отсчёт.
+     */
+    void restart();
+
+    /**
+     * @brief Возвращает время с момента запуска.
+     * 
+     * @return Время в секундах.
+     */
+    double elapsed() const;
+
+private:
+    chrono::steady_clock::time_point start_; ///< Момент запуска.
+};
+
+/**
+ * @brief Форматирует длительность в удобных единицах.
+ * 
+ * @param seconds Длительность в секундах.
+ * @return Строка вида "12.3 us".
+ */
+string FormatDuration(double seconds);
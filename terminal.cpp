@@ -1,25 +1,193 @@
 #include "terminal.h"
+#include "logger.h"
+#include "data.h"
+#include "uring.h"
 #include <iostream>
 #include <cstring>
+#include <sstream>
 
 // Конструктор
 Terminal::Terminal()
     : address_("127.0.0.1"), port_(33333),
-      config_path_("./config/vclient.conf") {}
+      config_path_("./config/vclient.conf"), zero_copy_(false),
+      streaming_(false), chunk_size_(1024), send_batch_(1024),
+      sessions_(1), window_(1), local_(false), verify_(false),
+      validate_(false), reduction_("sum"), kernel_("auto"), dedup_(false),
+      checkpoint_(false), retries_(3), deadline_(0),
+      log_level_("info"), dump_(false), threads_(0), element_type_("double"), io_backend_("blocking") {}
 
 string Terminal::getConfigPath() const
 {
     return this->config_path_;
 }
 
+bool Terminal::isZeroCopy() const
+{
+    return this->zero_copy_;
+}
+
+bool Terminal::isStreaming() const
+{
+    return this->streaming_;
+}
+
+size_t Terminal::getChunkSize() const
+{
+    return this->chunk_size_;
+}
+
+size_t Terminal::getSendBatch() const
+{
+    return this->send_batch_;
+}
+
+size_t Terminal::getSessions() const
+{
+    return this->sessions_;
+}
+
+size_t Terminal::getWindow() const
+{
+    return this->window_;
+}
+
+string Terminal::getManifestPath() const
+{
+    return this->manifest_path_;
+}
+
+bool Terminal::isLocal() const
+{
+    return this->local_;
+}
+
+bool Terminal::isVerify() const
+{
+    return this->verify_;
+}
+
+bool Terminal::isValidate() const
+{
+    return this->validate_;
+}
+
+string Terminal::getReduction() const
+{
+    return this->reduction_;
+}
+
+string Terminal::getKernel() const
+{
+    return this->kernel_;
+}
+
+string Terminal::getCachePath() const
+{
+    return this->cache_path_;
+}
+
+bool Terminal::isDedup() const
+{
+    return this->dedup_;
+}
+
+bool Terminal::isCheckpoint() const
+{
+    return this->checkpoint_;
+}
+
+size_t Terminal::getRetries() const
+{
+    return this->retries_;
+}
+
+size_t Terminal::getDeadline() const
+{
+    return this->deadline_;
+}
+
+string Terminal::getMetricsPath() const
+{
+    return this->metrics_path_;
+}
+
+string Terminal::getMetricsFormat() const
+{
+    return this->metrics_format_;
+}
+
+string Terminal::getLogLevel() const
+{
+    return this->log_level_;
+}
+
+bool Terminal::isDump() const
+{
+    return this->dump_;
+}
+
+SocketOptions Terminal::getSocketOptions() const
+{
+    return this->socket_options_;
+}
+
+size_t Terminal::getThreads() const
+{
+    return this->threads_;
+}
+
+string Terminal::getElementType() const
+{
+    return this->element_type_;
+}
+
+string Terminal::getIoBackend() const
+{
+    return this->io_backend_;
+}
+
 string Terminal::getAddress() const
 {
-    return this->address_;
+    return getEndpoints().front().address;
 }
 
 int Terminal::getPort() const
 {
-    return this->port_;
+    return getEndpoints().front().port;
+}
+
+// Метод для разбора списка серверов
+vector<Endpoint> Terminal::getEndpoints() const
+{
+    vector<Endpoint> endpoints;
+    istringstream list(this->address_);
+    string item;
+    while (getline(list, item, ','))
+    {
+        Endpoint endpoint = {item, this->port_};
+        size_t colon = item.rfind(':');
+        if (colon != string::npos)
+        {
+            endpoint.address = item.substr(0, colon);
+            int port = stoi(item.substr(colon + 1));
+            if (port <= 0 || port > 65535)
+            {
+                throw RuntimeError("Invalid port in server list: " + item, __func__);
+            }
+            endpoint.port = port;
+        }
+        if (endpoint.address.empty())
+        {
+            throw RuntimeError("Empty address in server list: " + this->address_, __func__);
+        }
+        endpoints.push_back(endpoint);
+    }
+
+    if (endpoints.empty())
+    {
+        throw RuntimeError("Empty server list", __func__);
+    }
+    return endpoints;
 }
 
 string Terminal::getInputPath() const
@@ -83,28 +251,368 @@ void Terminal::parseArgs(int argc, char *argv[])
             else
                 throw RuntimeError("Missing value for config parameter", __func__);
         }
+        else if (strcmp(argv[i], "-z") == 0 || strcmp(argv[i], "--zero-copy") == 0)
+        {
+            this->zero_copy_ = true;
+        }
+        else if (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--stream") == 0)
+        {
+            this->streaming_ = true;
+        }
+        else if (strcmp(argv[i], "--chunk-size") == 0)
+        {
+            if (i + 1 < argc)
+                this->chunk_size_ = stoul(argv[++i]);
+            else
+                throw RuntimeError("Missing value for chunk size parameter", __func__);
+            if (this->chunk_size_ == 0)
+                throw RuntimeError("Chunk size must be positive", __func__);
+        }
+        else if (strcmp(argv[i], "--send-batch") == 0)
+        {
+            if (i + 1 < argc)
+                this->send_batch_ = stoul(argv[++i]);
+            else
+                throw RuntimeError("Missing value for send batch parameter", __func__);
+        }
+        else if (strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--sessions") == 0)
+        {
+            if (i + 1 < argc)
+                this->sessions_ = stoul(argv[++i]);
+            else
+                throw RuntimeError("Missing value for sessions parameter", __func__);
+            if (this->sessions_ == 0)
+                throw RuntimeError("Number of sessions must be positive", __func__);
+        }
+        else if (strcmp(argv[i], "--window") == 0)
+        {
+            if (i + 1 < argc)
+                this->window_ = stoul(argv[++i]);
+            else
+                throw RuntimeError("Missing value for window parameter", __func__);
+            if (this->window_ == 0)
+                throw RuntimeError("Window size must be positive", __func__);
+        }
+        else if (strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--threads") == 0)
+        {
+            if (i + 1 < argc)
+                this->threads_ = stoul(argv[++i]);
+            else
+                throw RuntimeError("Missing value for threads parameter", __func__);
+        }
+        else if (strcmp(argv[i], "-T") == 0 || strcmp(argv[i], "--type") == 0)
+        {
+            if (i + 1 < argc)
+                this->element_type_ = argv[++i];
+            else
+                throw RuntimeError("Missing value for type parameter", __func__);
+        }
+        else if (strcmp(argv[i], "--io") == 0)
+        {
+            if (i + 1 < argc)
+                this->io_backend_ = argv[++i];
+            else
+                throw RuntimeError("Missing value for io parameter", __func__);
+        }
+        else if (strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--manifest") == 0)
+        {
+            if (i + 1 < argc)
+                this->manifest_path_ = argv[++i];
+            else
+                throw RuntimeError("Missing value for manifest parameter", __func__);
+        }
+        else if (strcmp(argv[i], "-L") == 0 || strcmp(argv[i], "--local") == 0)
+        {
+            this->local_ = true;
+        }
+        else if (strcmp(argv[i], "--verify") == 0)
+        {
+            this->verify_ = true;
+        }
+        else if (strcmp(argv[i], "--validate") == 0)
+        {
+            this->validate_ = true;
+        }
+        else if (strcmp(argv[i], "--op") == 0)
+        {
+            if (i + 1 < argc)
+                this->reduction_ = argv[++i];
+            else
+                throw RuntimeError("Missing value for op parameter", __func__);
+        }
+        else if (strcmp(argv[i], "--kernel") == 0)
+        {
+            if (i + 1 < argc)
+                this->kernel_ = argv[++i];
+            else
+                throw RuntimeError("Missing value for kernel parameter", __func__);
+        }
+        else if (strcmp(argv[i], "--cache") == 0)
+        {
+            if (i + 1 < argc)
+                this->cache_path_ = argv[++i];
+            else
+                throw RuntimeError("Missing value for cache parameter", __func__);
+        }
+        else if (strcmp(argv[i], "--dedup") == 0)
+        {
+            this->dedup_ = true;
+        }
+        else if (strcmp(argv[i], "--checkpoint") == 0)
+        {
+            this->checkpoint_ = true;
+        }
+        else if (strcmp(argv[i], "--retries") == 0)
+        {
+            if (i + 1 < argc)
+                this->retries_ = stoul(argv[++i]);
+            else
+                throw RuntimeError("Missing value for retries parameter", __func__);
+        }
+        else if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0)
+        {
+            this->log_level_ = "quiet";
+        }
+        else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0)
+        {
+            this->log_level_ = "debug";
+        }
+        else if (strcmp(argv[i], "--log-level") == 0)
+        {
+            if (i + 1 < argc)
+                this->log_level_ = argv[++i];
+            else
+                throw RuntimeError("Missing value for log level parameter", __func__);
+        }
+        else if (strcmp(argv[i], "--dump") == 0)
+        {
+            this->dump_ = true;
+        }
+        else if (strcmp(argv[i], "--no-nodelay") == 0)
+        {
+            this->socket_options_.nodelay = false;
+        }
+        else if (strcmp(argv[i], "--no-quickack") == 0)
+        {
+            this->socket_options_.quickack = false;
+        }
+        else if (strcmp(argv[i], "--sndbuf") == 0)
+        {
+            if (i + 1 < argc)
+                this->socket_options_.send_buffer = stoi(argv[++i]);
+            else
+                throw RuntimeError("Missing value for send buffer parameter", __func__);
+            if (this->socket_options_.send_buffer < 0)
+                throw RuntimeError("Send buffer size must not be negative", __func__);
+        }
+        else if (strcmp(argv[i], "--rcvbuf") == 0)
+        {
+            if (i + 1 < argc)
+                this->socket_options_.recv_buffer = stoi(argv[++i]);
+            else
+                throw RuntimeError("Missing value for receive buffer parameter", __func__);
+            if (this->socket_options_.recv_buffer < 0)
+                throw RuntimeError("Receive buffer size must not be negative", __func__);
+        }
+        else if (strcmp(argv[i], "--fastopen") == 0)
+        {
+            this->socket_options_.fastopen = true;
+        }
+        else if (strcmp(argv[i], "--busy-poll") == 0)
+        {
+            if (i + 1 < argc)
+                this->socket_options_.busy_poll = stoi(argv[++i]);
+            else
+                throw RuntimeError("Missing value for busy poll parameter", __func__);
+            if (this->socket_options_.busy_poll < 0)
+                throw RuntimeError("Busy poll time must not be negative", __func__);
+        }
+        else if (strcmp(argv[i], "--timeout") == 0)
+        {
+            if (i + 1 < argc)
+                this->socket_options_.timeout = stoi(argv[++i]);
+            else
+                throw RuntimeError("Missing value for timeout parameter", __func__);
+            if (this->socket_options_.timeout < 0)
+                throw RuntimeError("Timeout must not be negative", __func__);
+        }
+        else if (strcmp(argv[i], "--deadline") == 0)
+        {
+            if (i + 1 < argc)
+                this->deadline_ = stoul(argv[++i]);
+            else
+                throw RuntimeError("Missing value for deadline parameter", __func__);
+        }
+        else if (strcmp(argv[i], "--metrics") == 0)
+        {
+            if (i + 1 < argc)
+                this->metrics_path_ = argv[++i];
+            else
+                throw RuntimeError("Missing value for metrics parameter", __func__);
+        }
+        else if (strcmp(argv[i], "--metrics-format") == 0)
+        {
+            if (i + 1 < argc)
+                this->metrics_format_ = argv[++i];
+            else
+                throw RuntimeError("Missing value for metrics format parameter", __func__);
+        }
         else
         {
             throw RuntimeError("Unknown parameter: " + string(argv[i]), __func__);
         }
     }
 
+    ParseLogLevel(this->log_level_);
+    ElementType element_type = ParseElementType(this->element_type_);
+    ParseIoBackend(this->io_backend_);
+
+    // Формат метрик по умолчанию определяется расширением файла
+    if (this->metrics_format_.empty())
+    {
+        const string prom = ".prom";
+        bool is_prom = this->metrics_path_.size() >= prom.size() &&
+                       this->metrics_path_.compare(this->metrics_path_.size() - prom.size(), prom.size(), prom) == 0;
+        this->metrics_format_ = is_prom ? "prometheus" : "json";
+    }
+    if (this->metrics_format_ != "json" && this->metrics_format_ != "prometheus")
+    {
+        throw RuntimeError("Unknown metrics format: " + this->metrics_format_, __func__);
+    }
+
+    // Проверка списка серверов
+    if (getEndpoints().size() > 1 && (this->zero_copy_ || this->streaming_ || this->sessions_ > 1 || !this->manifest_path_.empty()))
+    {
+        throw RuntimeError("Several servers cannot be combined with --zero-copy, --stream, --sessions or --manifest", __func__);
+    }
+
+    // Локальные вычисления и сверка требуют всех векторов в памяти
+    if ((this->local_ || this->verify_) && (this->zero_copy_ || this->streaming_ || !this->manifest_path_.empty()))
+    {
+        throw RuntimeError("Options --local and --verify cannot be combined with --zero-copy, --stream or --manifest", __func__);
+    }
+    if ((!this->cache_path_.empty() || this->dedup_) && (this->zero_copy_ || this->streaming_ || !this->manifest_path_.empty()))
+    {
+        throw RuntimeError("Options --cache and --dedup cannot be combined with --zero-copy, --stream or --manifest", __func__);
+    }
+    if (this->validate_ && (this->zero_copy_ || this->streaming_))
+    {
+        throw RuntimeError("Option --validate cannot be combined with --zero-copy or --stream", __func__);
+    }
+    if (this->local_ && this->verify_)
+    {
+        throw RuntimeError("Options --local and --verify are mutually exclusive", __func__);
+    }
+
+    // Контрольные точки ведутся только для одной сессии с векторами в памяти
+    if (this->checkpoint_ && (this->zero_copy_ || this->streaming_ || this->sessions_ > 1 || getEndpoints().size() > 1 ||
+                              !this->manifest_path_.empty() || this->local_))
+    {
+        throw RuntimeError("Option --checkpoint cannot be combined with --zero-copy, --stream, --sessions, "
+                           "several servers, --manifest or --local", __func__);
+    }
+
+    // Окно запросов применяется к векторам в памяти, передаваемым одним клиентом
+    if (this->window_ > 1 && (this->zero_copy_ || this->streaming_ || this->sessions_ > 1 || getEndpoints().size() > 1 ||
+                              !this->manifest_path_.empty() || this->local_ || this->checkpoint_ || element_type != ElementType::Double))
+    {
+        throw RuntimeError("Option --window cannot be combined with --zero-copy, --stream, --sessions, several servers, "
+                           "--manifest, --local, --checkpoint or element types other than double", __func__);
+    }
+
+    // Типы, отличные от double, поддерживаются только основным режимом с одной сессией
+    if (element_type != ElementType::Double &&
+        (this->zero_copy_ || this->streaming_ || this->sessions_ > 1 || getEndpoints().size() > 1 || !this->manifest_path_.empty() ||
+         this->local_ || this->verify_ || !this->cache_path_.empty() || this->dedup_ || this->checkpoint_))
+    {
+        throw RuntimeError("Element type " + this->element_type_ + " cannot be combined with --zero-copy, --stream, --sessions, "
+                           "several servers, --manifest, --local, --verify, --cache, --dedup or --checkpoint", __func__);
+    }
+
     // Проверка, заданы ли все необходимые параметры
-    if (this->input_path_.empty() || this->output_path_.empty())
+    if (!this->manifest_path_.empty())
+    {
+        if (!this->input_path_.empty() || !this->output_path_.empty())
+        {
+            throw RuntimeError("Option --manifest cannot be combined with --input or --output", __func__);
+        }
+        if (this->zero_copy_ || this->streaming_ || this->sessions_ > 1)
+        {
+            throw RuntimeError("Option --manifest cannot be combined with --zero-copy, --stream or --sessions", __func__);
+        }
+    }
+    else if (this->input_path_.empty() || this->output_path_.empty())
     {
         throw RuntimeError("Missing mandatory input or output file path", __func__);
     }
+
+    if (this->zero_copy_ && this->streaming_)
+    {
+        throw RuntimeError("Options --zero-copy and --stream are mutually exclusive", __func__);
+    }
+    if (this->sessions_ > 1 && (this->zero_copy_ || this->streaming_))
+    {
+        throw RuntimeError("Option --sessions cannot be combined with --zero-copy or --stream", __func__);
+    }
 }
 
 // Метод для показа справки
 void Terminal::showHelp() const
 {
+    // Справка выводится напрямую, поэтому сначала дописываем журнал
+    Logger::instance().flush();
     cout << "Usage: vclient [options]\n"
          << "Options:\n"
          << "  -h, --help            Show this help message and exit\n"
-         << "  -a, --address ADDRESS Server address (default: 127.0.0.1)\n"
+         << "  -a, --address LIST    Server address or comma-separated ADDRESS[:PORT] list\n"
+         << "                        to spread vectors across (default: 127.0.0.1)\n"
          << "  -p, --port PORT       Server port (default: 33333)\n"
          << "  -i, --input PATH      Path to input data file\n"
          << "  -o, --output PATH     Path to output data file\n"
-         << "  -c, --config PATH     Path to config file (default: ./config/vclient.conf)\n";
+         << "  -c, --config PATH     Path to config file (default: ./config/vclient.conf)\n"
+         << "  -z, --zero-copy       Send input file to server as is via sendfile()\n"
+         << "  -s, --stream          Read, send, receive and write data in chunks\n"
+         << "      --chunk-size N    Vectors per chunk in --stream, -j, multi-server, --checkpoint\n"
+         << "                        and --window modes (default: 1024)\n"
+         << "      --send-batch N    Max iovec entries per sendmsg() call (default: 1024)\n"
+         << "  -j, --sessions N      Split vectors across N parallel sessions (default: 1)\n"
+         << "      --window N        Keep up to N requests of --chunk-size vectors in flight on one\n"
+         << "                        session (default: 1, all vectors in a single request)\n"
+         << "  -t, --threads N       Threads loading the input file (default: 0, one per core)\n"
+         << "  -T, --type NAME       Element type matching the server: int16, int32, int64, float,\n"
+         << "                        double (default: double)\n"
+         << "      --io NAME         I/O backend for file reads and requests: blocking, uring\n"
+         << "                        (default: blocking; uring falls back if unavailable)\n"
+         << "  -m, --manifest PATH   Run every \"input output\" pair listed in PATH over one session\n"
+         << "  -L, --local           Calculate locally without contacting the server\n"
+         << "      --verify          Cross-check server results against local calculation\n"
+         << "      --validate        Check loaded vectors for NaN, Inf and values that may overflow\n"
+         << "                        the element type before sending them\n"
+         << "      --op NAME         Local reduction matching the server: sum, product, mean, sumsq\n"
+         << "                        (default: sum)\n"
+         << "      --kernel NAME     Local and --validate kernel: auto, scalar, sse2, avx2 (default: auto)\n"
+         << "      --cache PATH      Reuse results of previously seen vectors stored in PATH\n"
+         << "      --dedup           Send each distinct vector once and fan results back out\n"
+         << "      --checkpoint      Send --chunk-size vectors per request, save completed chunks\n"
+         << "                        to OUTPUT.ckpt and resume from it after a failure or restart\n"
+         << "      --retries N       Reconnect attempts per chunk with --checkpoint (default: 3)\n"
+         << "  -q, --quiet           Log errors only\n"
+         << "  -v, --verbose         Log debug messages as well\n"
+         << "      --log-level NAME  Log level: quiet, info, debug (default: info)\n"
+         << "      --dump            Log input and result vectors in full instead of\n"
+         << "                        the first 8 entries\n"
+         << "      --no-nodelay      Keep Nagle's algorithm enabled (TCP_NODELAY is on by default)\n"
+         << "      --no-quickack     Keep delayed ACKs while waiting for results\n"
+         << "      --sndbuf BYTES    Socket send buffer size (default: kernel)\n"
+         << "      --rcvbuf BYTES    Socket receive buffer size (default: kernel)\n"
+         << "      --fastopen        Use TCP Fast Open for reconnects\n"
+         << "      --busy-poll USEC  Busy-poll the socket for USEC microseconds before sleeping\n"
+         << "      --timeout MS      Limit connect, authentication and each calculation request\n"
+         << "                        to MS milliseconds (default: 0, no limit)\n"
+         << "      --deadline MS     Limit the whole run to MS milliseconds (default: 0, no limit);\n"
+         << "                        an expired timeout or deadline exits with code 124\n"
+         << "      --metrics PATH    Write phase timings, I/O counters and peak RSS to PATH at exit\n"
+         << "      --metrics-format FORMAT\n"
+         << "                        Metrics format: json, prometheus (default: prometheus\n"
+         << "                        for *.prom files, json otherwise)\n";
 }
@@ -3,9 +3,39 @@
 #include "error.h"
 #include <string>
 #include <vector>
+#include <cstdint>
 
 using namespace std;
 
+/**
+ * @struct Endpoint
+ * @brief Адрес и порт одного сервера.
+ */
+struct Endpoint
+{
+    string address; ///< Адрес сервера.
+    uint16_t port;  ///< Порт сервера.
+};
+
+/**
+ * @struct SocketOptions
+ * @brief Параметры сокета подключения к серверу.
+ *
+ * Значения по умолчанию рассчитаны на низкую задержку: короткие заголовки запроса
+ * не ждут подтверждения из-за алгоритма Нейгла, а подтверждения ответов
+ * отправляются сразу. Нулевые размеры буферов оставляют значения ядра.
+ */
+struct SocketOptions
+{
+    bool nodelay = true;   ///< TCP_NODELAY: отключить алгоритм Нейгла.
+    bool quickack = true;  ///< TCP_QUICKACK перед каждым ожиданием ответа.
+    int send_buffer = 0;   ///< SO_SNDBUF в байтах (0 - значение ядра).
+    int recv_buffer = 0;   ///< SO_RCVBUF в байтах (0 - значение ядра).
+    bool fastopen = false; ///< TCP_FASTOPEN_CONNECT: данные в SYN при повторных подключениях.
+    int busy_poll = 0;     ///< SO_BUSY_POLL в микросекундах (0 - выключено).
+    int timeout = 0;       ///< Срок каждой фазы обмена в миллисекундах (0 - без ограничения).
+};
+
 /**
  * @class Terminal
  * @brief Класс для работы с параметрами командной строки и конфигурацией.
@@ -26,17 +56,154 @@ public:
     /**
      * @brief Возвращает адрес сервера.
      * 
-     * @return Адрес сервера.
+     * @return Адрес сервера (первого, если задан список серверов).
      */
     string getAddress() const;
 
     /**
      * @brief Возвращает порт сервера.
      * 
-     * @return Порт сервера.
+     * @return Порт сервера (первого, если задан список серверов).
      */
     int getPort() const;
 
+    /**
+     * @brief Возвращает список серверов.
+     * 
+     * Параметр адреса может содержать несколько серверов через запятую в виде
+     * ADDRESS или ADDRESS:PORT; для серверов без порта используется параметр порта.
+     * 
+     * @return Список серверов.
+     * @throws RuntimeError Если список серверов имеет неверный формат.
+     */
+    vector<Endpoint> getEndpoints() const;
+
+    /**
+     * @brief Проверяет, выполняются ли вычисления локально без обращения к серверу.
+     * 
+     * @return true, если выбран локальный режим.
+     */
+    bool isLocal() const;
+
+    /**
+     * @brief Проверяет, нужно ли сверять результаты сервера с локальными вычислениями.
+     * 
+     * @return true, если выбрана сверка.
+     */
+    bool isVerify() const;
+
+    /**
+     * @brief Проверяет, нужно ли проверять входные данные перед отправкой.
+     * 
+     * @return true, если выбрана проверка.
+     */
+    bool isValidate() const;
+
+    /**
+     * @brief Возвращает название операции свёртки для локальных вычислений.
+     * 
+     * @return Название операции.
+     */
+    string getReduction() const;
+
+    /**
+     * @brief Возвращает название набора инструкций для локальных вычислений.
+     * 
+     * @return Название набора инструкций.
+     */
+    string getKernel() const;
+
+    /**
+     * @brief Возвращает путь к файлу кэша результатов.
+     * 
+     * @return Путь к файлу кэша или пустая строка, если кэш не используется.
+     */
+    string getCachePath() const;
+
+    /**
+     * @brief Проверяет, нужно ли исключать повторяющиеся векторы перед передачей.
+     * 
+     * @return true, если повторы исключаются.
+     */
+    bool isDedup() const;
+
+    /**
+     * @brief Проверяет, нужно ли сохранять контрольные точки вычислений.
+     * 
+     * @return true, если результаты частей сохраняются рядом с выходным файлом.
+     */
+    bool isCheckpoint() const;
+
+    /**
+     * @brief Возвращает количество попыток переподключения для одной части.
+     * 
+     * @return Количество попыток.
+     */
+    size_t getRetries() const;
+
+    /**
+     * @brief Возвращает срок выполнения всего запуска.
+     * 
+     * @return Срок в миллисекундах (0 - без ограничения).
+     */
+    size_t getDeadline() const;
+
+    /**
+     * @brief Возвращает путь к файлу метрик.
+     * 
+     * @return Путь к файлу метрик (пустая строка, если метрики не сохраняются).
+     */
+    string getMetricsPath() const;
+
+    /**
+     * @brief Возвращает формат файла метрик.
+     * 
+     * @return "json" или "prometheus".
+     */
+    string getMetricsFormat() const;
+
+    /**
+     * @brief Возвращает уровень журнала.
+     * 
+     * @return Название уровня: quiet, info или debug.
+     */
+    string getLogLevel() const;
+
+    /**
+     * @brief Проверяет, нужно ли выводить дампы данных целиком.
+     * 
+     * @return true, если дампы не сокращаются.
+     */
+    bool isDump() const;
+
+    /**
+     * @brief Возвращает параметры сокета подключения.
+     * 
+     * @return Параметры сокета.
+     */
+    SocketOptions getSocketOptions() const;
+
+    /**
+     * @brief Возвращает количество потоков чтения входного файла.
+     * 
+     * @return Количество потоков (0 - по количеству ядер).
+     */
+    size_t getThreads() const;
+
+    /**
+     * @brief Возвращает тип элементов векторов.
+     * 
+     * @return Имя типа: int16, int32, int64, float или double.
+     */
+    string getElementType() const;
+
+    /**
+     * @brief Возвращает способ ввода-вывода.
+     * 
+     * @return Название способа: blocking или uring.
+     */
+    string getIoBackend() const;
+
     /**
      * @brief Возвращает путь к входному файлу.
      * 
@@ -58,6 +225,55 @@ public:
      */
     string getConfigPath() const;
 
+    /**
+     * @brief Проверяет, включён ли режим прямой передачи входного файла.
+     * 
+     * @return true, если входной файл передаётся серверу без разбора.
+     */
+    bool isZeroCopy() const;
+
+    /**
+     * @brief Проверяет, включён ли потоковый режим обработки.
+     * 
+     * @return true, если данные читаются, передаются и записываются по частям.
+     */
+    bool isStreaming() const;
+
+    /**
+     * @brief Возвращает количество векторов в одной части потоковой обработки.
+     * 
+     * @return Размер части.
+     */
+    size_t getChunkSize() const;
+
+    /**
+     * @brief Возвращает максимальное количество фрагментов в одном вызове sendmsg().
+     * 
+     * @return Размер пакета передачи.
+     */
+    size_t getSendBatch() const;
+
+    /**
+     * @brief Возвращает количество параллельных сессий с сервером.
+     * 
+     * @return Количество сессий.
+     */
+    size_t getSessions() const;
+
+    /**
+     * @brief Возвращает количество запросов, одновременно находящихся в полёте в одной сессии.
+     * 
+     * @return Размер окна (1 - один запрос со всеми векторами).
+     */
+    size_t getWindow() const;
+
+    /**
+     * @brief Возвращает путь к списку заданий пакетного режима.
+     * 
+     * @return Путь к списку заданий или пустая строка, если пакетный режим не выбран.
+     */
+    string getManifestPath() const;
+
     /**
      * @brief Разбирает аргументы командной строки и устанавливает соответствующие параметры.
      * 
@@ -75,9 +291,34 @@ public:
     void showHelp() const;
 
 private:
-    string address_;     ///< Адрес сервера.
-    uint16_t port_;      ///< Порт сервера.
-    string input_path_;  ///< Путь к входному файлу.
-    string output_path_; ///< Путь к выходному файлу.
-    string config_path_; ///< Путь к файлу конфигурации.
+    string address_;               ///< Адрес сервера.
+    uint16_t port_;                ///< Порт сервера.
+    string input_path_;            ///< Путь к входному файлу.
+    string output_path_;           ///< Путь к выходному файлу.
+    string config_path_;           ///< Путь к файлу конфигурации.
+    bool zero_copy_;               ///< Режим прямой передачи входного файла.
+    bool streaming_;               ///< Потоковый режим обработки.
+    size_t chunk_size_;            ///< Количество векторов в одной части.
+    size_t send_batch_;            ///< Максимальное количество фрагментов в одном вызове sendmsg().
+    size_t sessions_;              ///< Количество параллельных сессий с сервером.
+    size_t window_;                ///< Количество запросов в полёте в одной сессии.
+    string manifest_path_;         ///< Путь к списку заданий пакетного режима.
+    bool local_;                   ///< Локальные вычисления без обращения к серверу.
+    bool verify_;                  ///< Сверка результатов сервера с локальными вычислениями.
+    bool validate_;                ///< Проверка входных данных перед отправкой.
+    string reduction_;             ///< Операция свёртки для локальных вычислений.
+    string kernel_;                ///< Набор инструкций для локальных вычислений.
+    string cache_path_;            ///< Путь к файлу кэша результатов.
+    bool dedup_;                   ///< Исключение повторяющихся векторов перед передачей.
+    bool checkpoint_;              ///< Сохранение контрольных точек вычислений.
+    size_t retries_;               ///< Количество попыток переподключения для одной части.
+    size_t deadline_;              ///< Срок выполнения всего запуска в миллисекундах.
+    string metrics_path_;          ///< Путь к файлу метрик.
+    string metrics_format_;        ///< Формат файла метрик.
+    string log_level_;             ///< Уровень журнала.
+    bool dump_;                    ///< Вывод дампов данных целиком.
+    SocketOptions socket_options_; ///< Параметры сокета подключения.
+    size_t threads_;               ///< Количество потоков чтения входного файла.
+    string element_type_;          ///< Тип элементов векторов.
+    string io_backend_;            ///< Способ ввода-вывода.
 };
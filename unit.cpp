@@ -3,6 +3,21 @@
 #include "client.h"
 #include "terminal.h"
 #include "error.h"
+#include "pipeline.h"
+#include "reader.h"
+#include "pool.h"
+#include "dispatch.h"
+#include "engine.h"
+#include "cache.h"
+#include "dedup.h"
+#include "checkpoint.h"
+#include "validate.h"
+#include "stats.h"
+#include "loopback.h"
+#include "metrics.h"
+#include "logger.h"
+#include <sys/socket.h>
+#include <cfloat>
 
 /**
  * @brief Тесты для модуля DataHandler.
@@ -37,7 +52,7 @@ SUITE(DataHandlerTests)
     TEST(ReadDataTest)
     {
         DataHandler dataHandler("./config/vclient.conf", "./input.bin", "./output.bin");
-        vector<vector<double>> data = dataHandler.readData();
+        VectorBatch data = dataHandler.readData();
         CHECK_EQUAL(3, data.size()); // Предполагается, что файл содержит 3 вектора
         CHECK_EQUAL(3, data[0].size());
         CHECK_CLOSE(14479.95, data[0][0], 0.01);
@@ -70,29 +85,1407 @@ SUITE(DataHandlerTests)
         output_file.close();
     }
 
+    /**
+     * @brief Тест чтения и записи векторов с элементами int16_t.
+     */
+    TEST(TypedReadWriteTest)
+    {
+        {
+            ofstream input_file("./typed_input.bin", ios::binary);
+            uint32_t count = 2, size = 3;
+            int16_t values[] = {1, -2, 300, 7, 8, 9};
+            input_file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+            input_file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+            input_file.write(reinterpret_cast<const char *>(values), 3 * sizeof(int16_t));
+            input_file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+            input_file.write(reinterpret_cast<const char *>(values + 3), 3 * sizeof(int16_t));
+        }
+
+        DataHandler dataHandler("./config/vclient.conf", "./typed_input.bin", "./typed_output.bin");
+        BasicVectorBatch<int16_t> data = dataHandler.readData<int16_t>();
+        CHECK_EQUAL(2u, data.size());
+        CHECK_EQUAL(300, data[0][2]);
+        CHECK_EQUAL(7, data[1][0]);
+        CHECK_EQUAL("[ 1 -2 300 ]", FormatVector(data[0]));
+
+        // Тот же файл, прочитанный как int32, не сходится по размеру
+        CHECK_THROW(dataHandler.readData<int32_t>(), RuntimeError);
+
+        dataHandler.writeData(vector<int16_t>{299, 24});
+        ifstream output_file("./typed_output.bin", ios::binary | ios::ate);
+        CHECK_EQUAL(int(sizeof(uint32_t) + 2 * sizeof(int16_t)), int(output_file.tellg()));
+        output_file.seekg(sizeof(uint32_t));
+        int16_t value;
+        output_file.read(reinterpret_cast<char *>(&value), sizeof(value));
+        CHECK_EQUAL(299, value);
+        remove("./typed_input.bin");
+        remove("./typed_output.bin");
+    }
+
+    /**
+     * @brief Тест проверки структуры входного файла.
+     */
+    TEST(ScanDataTest)
+    {
+        DataHandler dataHandler("./config/vclient.conf", "./input.bin", "./output.bin");
+        CHECK_EQUAL(3, dataHandler.scanData());
+    }
+
+    /**
+     * @brief Тест выброса исключения при обрезанном входном файле.
+     */
+    TEST(CheckThrowScanTruncated)
+    {
+        ofstream truncated("./truncated.bin", ios::binary);
+        uint32_t header[2] = {2, 4};
+        double value = 1.0;
+        truncated.write(reinterpret_cast<const char *>(header), sizeof(header));
+        truncated.write(reinterpret_cast<const char *>(&value), sizeof(value));
+        truncated.close();
+
+        DataHandler dataHandler("./config/vclient.conf", "./truncated.bin", "./output.bin");
+        CHECK_THROW(dataHandler.scanData(), RuntimeError);
+        remove("./truncated.bin");
+    }
+
+    /**
+     * @brief Тест чтения данных по частям.
+     */
+    TEST(DataReaderChunksTest)
+    {
+        DataReader reader("./input.bin");
+        CHECK_EQUAL(3, reader.getCount());
+
+        VectorBatch chunk;
+        CHECK_EQUAL(2, reader.readChunk(chunk, 2));
+        CHECK_CLOSE(14479.95, chunk[0][0], 0.01);
+        CHECK_EQUAL(1, reader.readChunk(chunk, 2));
+        CHECK_EQUAL(3, chunk[0].size());
+        CHECK_EQUAL(0, reader.readChunk(chunk, 2));
+    }
+
+    /**
+     * @brief Тест выброса исключения до выделения памяти, если размер вектора больше остатка файла.
+     */
+    TEST(CheckThrowDataReaderOversizedVector)
+    {
+        {
+            ofstream input_file("./oversized.bin", ios::binary);
+            uint32_t header[2] = {1, 0x7FFFFFFF};
+            input_file.write(reinterpret_cast<const char *>(header), sizeof(header));
+            input_file.write(string(68, '\0').data(), 68);
+        }
+        DataReader reader("./oversized.bin");
+        VectorBatch chunk;
+        CHECK_THROW(reader.readChunk(chunk, 1), RuntimeError);
+        CHECK_EQUAL(0u, chunk.elementCount());
+        remove("./oversized.bin");
+    }
+
+    /**
+     * @brief Тест записи результатов по мере поступления.
+     */
+    TEST(DataWriterAppendTest)
+    {
+        DataWriter writer("./output.bin", 3);
+        writer.append({1.0, 2.0});
+        CHECK_THROW(writer.append({3.0, 4.0}), RuntimeError);
+        writer.append({3.0});
+        writer.close();
+
+        ifstream output_file("./output.bin", ios::binary);
+        uint32_t size;
+        double values[3];
+        output_file.read(reinterpret_cast<char *>(&size), sizeof(size));
+        output_file.read(reinterpret_cast<char *>(values), sizeof(values));
+        CHECK_EQUAL(3, size);
+        CHECK_EQUAL(3.0, values[2]);
+    }
+
+    /**
+     * @brief Тест выброса исключения при записи не всех результатов и укорачивания файла.
+     */
+    TEST(CheckThrowDataWriterIncomplete)
+    {
+        {
+            DataWriter writer("./output.bin", 2);
+            writer.append({1.0});
+            CHECK_THROW(writer.close(), RuntimeError);
+        }
+        ifstream output_file("./output.bin", ios::binary | ios::ate);
+        CHECK_EQUAL(int(sizeof(uint32_t) + sizeof(double)), int(output_file.tellg()));
+    }
+
+    /**
+     * @brief Тест выделения места под выходной файл до записи результатов.
+     */
+    TEST(DataWriterPreallocateTest)
+    {
+        DataWriter writer("./output.bin", 1000, sizeof(float));
+        {
+            ifstream output_file("./output.bin", ios::binary | ios::ate);
+            CHECK_EQUAL(4004, int(output_file.tellg()));
+        }
+        CHECK_THROW(writer.append(vector<double>{1.0}), RuntimeError);
+        writer.append(vector<float>(999, 0.5f));
+        writer.append(vector<float>{2.5f});
+        writer.close();
+
+        ifstream output_file("./output.bin", ios::binary);
+        uint32_t size;
+        output_file.read(reinterpret_cast<char *>(&size), sizeof(size));
+        CHECK_EQUAL(1000, size);
+        output_file.seekg(sizeof(size) + 999 * sizeof(float));
+        float last;
+        output_file.read(reinterpret_cast<char *>(&last), sizeof(last));
+        CHECK_EQUAL(2.5f, last);
+    }
+
+    /**
+     * @brief Тест загрузки списка заданий пакетного режима.
+     */
+    TEST(LoadManifestTest)
+    {
+        ofstream manifest("./manifest.txt");
+        manifest << "# input output\n"
+                 << "a.bin a.out\n"
+                 << "\n"
+                 << "  b.bin\tb.out  \n";
+        manifest.close();
+
+        vector<Job> jobs = LoadManifest("./manifest.txt");
+        CHECK_EQUAL(2, jobs.size());
+        CHECK_EQUAL("a.bin", jobs[0].input_path);
+        CHECK_EQUAL("b.out", jobs[1].output_path);
+        remove("./manifest.txt");
+    }
+
+    /**
+     * @brief Тест выброса исключения при строке списка заданий без выходного файла.
+     */
+    TEST(CheckThrowManifestMissingOutput)
+    {
+        ofstream manifest("./manifest.txt");
+        manifest << "a.bin\n";
+        manifest.close();
+
+        CHECK_THROW(LoadManifest("./manifest.txt"), RuntimeError);
+        remove("./manifest.txt");
+    }
+
+    /**
+     * @brief Тест параллельной загрузки с мелкими и крупными векторами.
+     */
+    TEST(ParallelReadDataTest)
+    {
+        // Файл больше порога многопоточного чтения, один вектор больше блока чтения
+        VectorBatch expected;
+        for (size_t i = 0; i < 20001; ++i)
+        {
+            expected.append(i == 10000 ? 1200000 : i % 13);
+            for (size_t j = 0; j < expected[i].size(); ++j)
+            {
+                expected.data(i)[j] = i * 0.5 + j;
+            }
+        }
+        ofstream file("./parallel.bin", ios::binary);
+        uint32_t count = expected.size();
+        file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+        for (const auto &vec : expected)
+        {
+            uint32_t size = vec.size();
+            file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+            file.write(reinterpret_cast<const char *>(vec.data()), size * sizeof(double));
+        }
+        file.close();
+
+        DataHandler dataHandler("./config/vclient.conf", "./parallel.bin", "./output.bin");
+        vector<VectorExtent> extents = dataHandler.indexData();
+        CHECK_EQUAL(expected.size(), extents.size());
+        CHECK_EQUAL(8u, extents[0].offset);
+        CHECK_EQUAL(12u, extents[1].offset);
+        CHECK_EQUAL(1u, extents[1].size);
+        CHECK_EQUAL(24u, extents[2].offset);
+        CHECK(expected == dataHandler.readData(4));
+        CHECK(expected == dataHandler.readData());
+
+        // Тот же набор в формате v2 с контрольными суммами
+        IndexedWriter writer("./parallel2.bin", expected.size(), true);
+        for (const auto &vec : expected)
+        {
+            writer.append(vec);
+        }
+        writer.close();
+        DataHandler indexed("./config/vclient.conf", "./parallel2.bin", "./output.bin");
+        CHECK_EQUAL(2u, indexed.getFormatVersion());
+        CHECK_EQUAL(0u, indexed.indexData()[1].offset % 64);
+        CHECK(expected == indexed.readData(4));
+        VectorBatch range = indexed.readRange(9999, 10002);
+        CHECK_EQUAL(3u, range.size());
+        CHECK(expected[10000] == range[1]);
+        CHECK_THROW(indexed.scanData(), RuntimeError);
+
+        // Чтение через io_uring (или блокирующее, если он недоступен) даёт те же данные
+        dataHandler.setIoBackend(IoBackend::Uring);
+        indexed.setIoBackend(IoBackend::Uring);
+        CHECK(expected == dataHandler.readData(4));
+        CHECK(expected == indexed.readData());
+        remove("./parallel.bin");
+        remove("./parallel2.bin");
+    }
+
+    /**
+     * @brief Тест потокового чтения формата v2 и проверки контрольных сумм.
+     */
+    TEST(FormatV2ChecksumTest)
+    {
+        VectorBatch expected = {{1.0, 2.0}, {}, {3.0}};
+        IndexedWriter writer("./indexed.bin", expected.size(), true);
+        for (const auto &vec : expected)
+        {
+            writer.append(vec);
+        }
+        writer.close();
+
+        DataReader reader("./indexed.bin");
+        VectorBatch chunk;
+        CHECK_EQUAL(3u, reader.getCount());
+        CHECK_EQUAL(3u, reader.readChunk(chunk, 10));
+        CHECK(expected == chunk);
+
+        // Порча одного значения обнаруживается при чтении
+        DataHandler dataHandler("./config/vclient.conf", "./indexed.bin", "./output.bin");
+        fstream file("./indexed.bin", ios::binary | ios::in | ios::out);
+        double corrupted = 5.0;
+        file.seekp(dataHandler.indexData()[2].offset);
+        file.write(reinterpret_cast<const char *>(&corrupted), sizeof(corrupted));
+        file.close();
+        CHECK_THROW(dataHandler.readData(), RuntimeError);
+        CHECK_EQUAL(2u, dataHandler.readRange(0, 2).size());
+        remove("./indexed.bin");
+    }
+
+    /**
+     * @brief Тест выброса исключения при чтении обрезанного файла.
+     */
+    TEST(CheckThrowReadTruncated)
+    {
+        ofstream file("./truncated.bin", ios::binary);
+        uint32_t header[] = {2, 1};
+        double value = 1.0;
+        file.write(reinterpret_cast<const char *>(header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+        file.close();
+
+        DataHandler dataHandler("./config/vclient.conf", "./truncated.bin", "./output.bin");
+        CHECK_THROW(dataHandler.readData(), RuntimeError);
+        remove("./truncated.bin");
+    }
+
+    /**
+     * @brief Тест размещения векторов в общей области памяти.
+     */
+    TEST(VectorBatchTest)
+    {
+        VectorBatch batch = {{1.0, 2.0}, {}, {3.0}};
+        CHECK_EQUAL(3u, batch.size());
+        CHECK_EQUAL(3u, batch.elementCount());
+        CHECK_EQUAL(2u, batch[0].size());
+        CHECK(batch[1].empty());
+        CHECK_EQUAL(3.0, batch[2][0]);
+        CHECK_EQUAL(batch[0].data() + 2, batch[2].data());
+
+        batch.append(2);
+        batch.data(3)[1] = 5.0;
+        batch.push_back(vector<double>{7.0});
+        size_t vectors = 0;
+        double sum = 0.0;
+        for (const auto &vec : batch)
+        {
+            ++vectors;
+            for (double value : vec)
+            {
+                sum += value;
+            }
+        }
+        CHECK_EQUAL(5u, vectors);
+        CHECK_EQUAL(18.0, sum);
+        CHECK(batch == VectorBatch(vector<vector<double>>{{1.0, 2.0}, {}, {3.0}, {0.0, 5.0}, {7.0}}));
+
+        batch.clear();
+        CHECK(batch.empty());
+        CHECK_EQUAL(0u, batch.elementCount());
+    }
+
+    /**
+     * @brief Тест сокращения дампов векторов.
+     */
+    TEST(FormatVectorsLimitTest)
+    {
+        CHECK_EQUAL("[ 1.00 2.50 ]", FormatVector({1.0, 2.5}));
+        CHECK_EQUAL("[ 1.00 ... (2 more) ]", FormatVector({1.0, 2.0, 3.0}, 1));
+        CHECK_EQUAL("[\n  [ 1.00 ... (1 more) ]\n  ... (1 more vectors)\n]", FormatVectors({{1.0, 2.0}, {3.0}}, 1));
+
+        // Большие значения выводятся целиком и разделяются пробелом
+        ostringstream expected;
+        expected << fixed << setprecision(2) << "[ " << 1e40 << " " << -DBL_MAX << " ]";
+        CHECK_EQUAL(expected.str(), FormatVector({1e40, -DBL_MAX}));
+    }
+
     /**
      * @brief Тест выброса исключения при отсутствии файла конфигурации.
      */
-    TEST(CheckThrowFileNotFound)
+    TEST(CheckThrowFileNotFound)
+    {
+        DataHandler dataHandler("./config/invalid.conf", "./input.bin", "./output.bin");
+        CHECK_THROW(dataHandler.loadConfig(), RuntimeError);
+    }
+}
+
+/**
+ * @brief Тесты для модуля Client.
+ */
+SUITE(ClientTests)
+{
+    /**
+     * @brief Тест конструктора класса Client.
+     */
+    TEST(ConstructorTest)
+    {
+        Client client("127.0.0.1", 33333);
+        CHECK_EQUAL("127.0.0.1", client.getAddress());
+        CHECK_EQUAL(33333, client.getPort());
+    }
+
+    /**
+     * @brief Тест ограничения размера пакета передачи.
+     */
+    TEST(BatchLimitTest)
+    {
+        Client client("127.0.0.1", 33333);
+        client.setBatchLimit(64);
+        CHECK_EQUAL(64, client.getBatchLimit());
+        client.setBatchLimit(0);
+        CHECK_EQUAL(2, client.getBatchLimit());
+        client.setBatchLimit(1000000);
+        CHECK_EQUAL(IOV_MAX, client.getBatchLimit());
+    }
+
+    /**
+     * @brief Тест выброса исключения при переподключении до аутентификации.
+     */
+    TEST(CheckThrowReconnectWithoutAuth)
+    {
+        Client client("127.0.0.1", 33333);
+        CHECK(!client.isConnected());
+        CHECK_THROW(client.reconnect(), RuntimeError);
+        CHECK_EQUAL(0, client.getReconnects());
+    }
+
+    /**
+     * @brief Тест закрытия сокета при неудачном подключении.
+     */
+    TEST(CheckThrowConnectClosesSocket)
+    {
+        Client invalid("not an address", 33333);
+        CHECK_THROW(invalid.connectToServer(), RuntimeError);
+        CHECK(!invalid.isConnected());
+
+        // Подключение к порту остановленного сервера отклоняется
+        LoopbackServer server("secret");
+        server.start();
+        Client refused("127.0.0.1", server.getPort());
+        server.stop();
+        CHECK_THROW(refused.connectToServer(), RuntimeError);
+        CHECK(!refused.isConnected());
+    }
+
+    /**
+     * @brief Тест сроков: незаданный срок бесконечен, из двух выбирается более ранний.
+     */
+    TEST(DeadlineTest)
+    {
+        Deadline unlimited;
+        CHECK(!unlimited.isSet());
+        CHECK(!unlimited.expired());
+        CHECK_EQUAL(-1, unlimited.remaining());
+
+        Deadline soon(chrono::milliseconds(1500));
+        CHECK(soon.remaining() > 1000 && soon.remaining() <= 1500);
+        CHECK_EQUAL(soon.remaining(), unlimited.earliest(soon).remaining());
+        Deadline past(chrono::steady_clock::now() - chrono::seconds(1));
+        CHECK(past.expired());
+        CHECK_EQUAL(0, past.remaining());
+        CHECK(soon.earliest(past).expired());
+    }
+
+    /**
+     * @brief Тест выброса TimeoutError при зависшем сервере и истёкшем сроке задания.
+     */
+    TEST(CheckThrowTimeout)
+    {
+        // Сервер принимает соединение, но ничего не отвечает
+        int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(listener, reinterpret_cast<struct sockaddr *>(&address), sizeof(address));
+        listen(listener, 4);
+        socklen_t length = sizeof(address);
+        getsockname(listener, reinterpret_cast<struct sockaddr *>(&address), &length);
+
+        Client client("127.0.0.1", ntohs(address.sin_port));
+        SocketOptions options;
+        options.timeout = 100;
+        client.setSocketOptions(options);
+        client.connectToServer();
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        CHECK_THROW(client.authenticate("user", "secret"), TimeoutError);
+        CHECK(chrono::steady_clock::now() - start < chrono::seconds(2));
+        client.closeConnection();
+
+        Client late("127.0.0.1", ntohs(address.sin_port));
+        late.setJobDeadline(Deadline(chrono::steady_clock::now()));
+        CHECK_THROW(late.connectToServer(), TimeoutError);
+        ::close(listener);
+    }
+}
+
+/**
+ * @brief Тесты для модуля SocketReader.
+ */
+SUITE(SocketReaderTests)
+{
+    /**
+     * @brief Тест чтения фрагментов точной длины поверх частично пришедших данных.
+     */
+    TEST(ReadExactTest)
+    {
+        int fds[2];
+        CHECK_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+        SocketReader reader(8);
+        reader.reset(fds[0]);
+
+        double values[3] = {1.5, -2.5, 3.5};
+        CHECK_EQUAL(2, write(fds[1], "OK", 2));
+        CHECK_EQUAL(sizeof(values), write(fds[1], values, sizeof(values)));
+
+        char response[2];
+        reader.readExact(response, sizeof(response), "response");
+        CHECK_EQUAL('O', response[0]);
+        CHECK_EQUAL('K', response[1]);
+
+        double received[3];
+        reader.readExact(received, sizeof(received), "results");
+        CHECK_EQUAL(-2.5, received[1]);
+        CHECK_EQUAL(3.5, received[2]);
+        CHECK_EQUAL(0, reader.buffered());
+
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    /**
+     * @brief Тест выброса исключения при закрытии соединения посреди фрагмента.
+     */
+    TEST(CheckThrowClosedMidFrame)
+    {
+        int fds[2];
+        CHECK_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+        SocketReader reader;
+        reader.reset(fds[0]);
+
+        CHECK_EQUAL(4, write(fds[1], "abcd", 4));
+        close(fds[1]);
+
+        double value;
+        CHECK_THROW(reader.readExact(&value, sizeof(value), "result"), RuntimeError);
+        close(fds[0]);
+    }
+}
+
+/**
+ * @brief Тесты для модуля Pipeline.
+ */
+SUITE(PipelineTests)
+{
+    /**
+     * @brief Тест извлечения оставшихся частей из закрытой очереди.
+     */
+    TEST(ChunkQueueCloseTest)
+    {
+        ChunkQueue queue(2);
+        CHECK(queue.push(VectorBatch(1)));
+        queue.close();
+
+        VectorBatch chunk;
+        CHECK(queue.pop(chunk));
+        CHECK_EQUAL(1, chunk.size());
+        CHECK(!queue.pop(chunk));
+    }
+
+    /**
+     * @brief Тест отмены очереди.
+     */
+    TEST(ChunkQueueCancelTest)
+    {
+        ChunkQueue queue(2);
+        CHECK(queue.push(VectorBatch(1)));
+        queue.cancel();
+
+        VectorBatch chunk;
+        CHECK(!queue.pop(chunk));
+        CHECK(!queue.push(VectorBatch(1)));
+    }
+
+    /**
+     * @brief Тест потоковой обработки файла через сервер с записью результатов в выходной файл.
+     */
+    TEST(LoopbackRunTest)
+    {
+        VectorBatch data;
+        {
+            ofstream input_file("./pipeline_input.bin", ios::binary);
+            uint32_t count = 25;
+            input_file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                vector<double> values = {i * 1.0, 0.25, -3.0};
+                uint32_t size = values.size();
+                input_file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+                input_file.write(reinterpret_cast<const char *>(values.data()), size * sizeof(double));
+                data.push_back(values);
+            }
+        }
+
+        LoopbackServer server("secret");
+        server.start();
+        Client client("127.0.0.1", server.getPort());
+        client.connectToServer();
+        client.authenticate("user", "secret");
+
+        DataReader reader("./pipeline_input.bin");
+        DataWriter writer("./pipeline_output.bin", reader.getCount());
+        Pipeline pipeline(client, 4);
+        CHECK_EQUAL(25u, pipeline.run(reader, writer));
+        client.closeConnection();
+        server.stop();
+        CHECK_EQUAL(1u, server.getRequests());
+
+        ifstream output_file("./pipeline_output.bin", ios::binary);
+        uint32_t count;
+        vector<double> results(25);
+        output_file.read(reinterpret_cast<char *>(&count), sizeof(count));
+        output_file.read(reinterpret_cast<char *>(results.data()), results.size() * sizeof(double));
+        CHECK_EQUAL(25u, count);
+        CHECK(LocalEngine(Reduction::Sum, Kernel::Scalar).calculate(data) == results);
+        remove("./pipeline_input.bin");
+        remove("./pipeline_output.bin");
+    }
+}
+
+/**
+ * @brief Тесты для модуля ClientPool.
+ */
+SUITE(ClientPoolTests)
+{
+    /**
+     * @brief Тест создания пула сессий.
+     */
+    TEST(ConstructorTest)
+    {
+        ClientPool pool("127.0.0.1", 33333, 3);
+        CHECK_EQUAL(3, pool.size());
+        CHECK_EQUAL(0, pool.getStolen());
+    }
+
+    /**
+     * @brief Тест выброса исключения при нулевом количестве сессий.
+     */
+    TEST(CheckThrowZeroSessions)
+    {
+        CHECK_THROW(ClientPool("127.0.0.1", 33333, 0), RuntimeError);
+    }
+
+    /**
+     * @brief Тест вычисления через несколько сессий с сохранением исходного порядка.
+     */
+    TEST(LoopbackCalculateTest)
+    {
+        LoopbackServer server("secret");
+        server.start();
+        ClientPool pool("127.0.0.1", server.getPort(), 3);
+        pool.connect("user", "secret");
+
+        VectorBatch data;
+        for (size_t i = 0; i < 50; ++i)
+        {
+            data.push_back({i * 1.0, -0.5, 2.0});
+        }
+        CHECK(LocalEngine(Reduction::Sum, Kernel::Scalar).calculate(data) == pool.calculate(data, 4));
+        pool.closeConnections();
+        server.stop();
+        CHECK_EQUAL(3u, server.getConnections());
+        CHECK_EQUAL(13u, server.getRequests());
+    }
+
+    /**
+     * @brief Тест перехвата частей у сессии, занятой большим вектором.
+     */
+    TEST(LoopbackWorkStealingTest)
+    {
+        LoopbackServer server("secret");
+        server.start();
+        ClientPool pool("127.0.0.1", server.getPort(), 2);
+        pool.connect("user", "secret");
+
+        // Первая часть первой сессии намного больше остальных, вторая сессия успевает перехватить её блок
+        VectorBatch data;
+        data.push_back(vector<double>(1 << 21, 1.0));
+        for (size_t i = 1; i < 20; ++i)
+        {
+            data.push_back({i * 1.0});
+        }
+        vector<double> results = pool.calculate(data, 1);
+        pool.closeConnections();
+        server.stop();
+        CHECK(LocalEngine(Reduction::Sum, Kernel::Scalar).calculate(data) == results);
+        CHECK(pool.getStolen() > 0);
+        CHECK(pool.getStolen() < 10);
+        CHECK_EQUAL(20u, server.getRequests());
+    }
+}
+
+/**
+ * @brief Тесты для модуля Dispatcher.
+ */
+SUITE(DispatcherTests)
+{
+    /**
+     * @brief Тест начальной статистики серверов.
+     */
+    TEST(ConstructorTest)
+    {
+        vector<Endpoint> endpoints = {{"127.0.0.1", 33333}, {"127.0.0.2", 44444}};
+        Dispatcher dispatcher(endpoints);
+        vector<ServerStats> stats = dispatcher.getStats();
+        CHECK_EQUAL(2, stats.size());
+        CHECK_EQUAL(44444, stats[1].endpoint.port);
+        CHECK(!stats[0].alive);
+        CHECK_EQUAL(0, stats[0].vectors);
+    }
+
+    /**
+     * @brief Тест выброса исключения при пустом списке серверов.
+     */
+    TEST(CheckThrowEmptyEndpoints)
+    {
+        CHECK_THROW(Dispatcher(vector<Endpoint>()), RuntimeError);
+    }
+
+    /**
+     * @brief Тест распределения частей между двумя серверами с восстановлением исходного порядка.
+     */
+    TEST(LoopbackRoundTripTest)
+    {
+        LoopbackServer first("secret");
+        LoopbackServer second("secret");
+        first.start();
+        second.start();
+
+        VectorBatch data;
+        for (size_t i = 0; i < 50; ++i)
+        {
+            data.push_back({i * 1.0, 0.5, -2.0});
+        }
+        vector<Endpoint> endpoints = {{"127.0.0.1", first.getPort()}, {"127.0.0.1", second.getPort()}};
+        Dispatcher dispatcher(endpoints);
+        CHECK_EQUAL(2u, dispatcher.connect("user", "secret"));
+        CHECK(LocalEngine(Reduction::Sum, Kernel::Scalar).calculate(data) == dispatcher.calculate(data, 4));
+        dispatcher.closeConnections();
+
+        vector<ServerStats> stats = dispatcher.getStats();
+        CHECK_EQUAL(50u, stats[0].vectors + stats[1].vectors);
+        CHECK_EQUAL(0u, stats[0].failures + stats[1].failures);
+        CHECK_EQUAL(13u, first.getRequests() + second.getRequests());
+    }
+
+    /**
+     * @brief Тест возврата частей в очередь и переподключения к серверу, закрывающему соединение после запроса.
+     */
+    TEST(LoopbackSingleRequestReconnectTest)
+    {
+        LoopbackServer single("secret", Reduction::Sum, true);
+        LoopbackServer other("secret");
+        single.start();
+        other.start();
+
+        VectorBatch data;
+        for (size_t i = 0; i < 40; ++i)
+        {
+            data.push_back({i * 2.0, 1.0});
+        }
+        vector<Endpoint> endpoints = {{"127.0.0.1", single.getPort()}, {"127.0.0.1", other.getPort()}};
+        Dispatcher dispatcher(endpoints);
+        dispatcher.connect("user", "secret");
+        CHECK(LocalEngine(Reduction::Sum, Kernel::Scalar).calculate(data) == dispatcher.calculate(data, 2));
+        dispatcher.closeConnections();
+
+        // Вторая часть в полёте теряется при закрытии соединения и отправляется заново
+        vector<ServerStats> stats = dispatcher.getStats();
+        CHECK(stats[0].failures >= 1);
+        CHECK(single.getConnections() > 1);
+        CHECK_EQUAL(40u, stats[0].vectors + stats[1].vectors);
+    }
+
+    /**
+     * @brief Тест передачи частей остановленного сервера оставшемуся.
+     */
+    TEST(LoopbackFailoverTest)
+    {
+        LoopbackServer stopped("secret");
+        LoopbackServer alive("secret");
+        stopped.start();
+        alive.start();
+
+        VectorBatch data;
+        for (size_t i = 0; i < 30; ++i)
+        {
+            data.push_back({i * 1.0});
+        }
+        vector<Endpoint> endpoints = {{"127.0.0.1", stopped.getPort()}, {"127.0.0.1", alive.getPort()}};
+        Dispatcher dispatcher(endpoints);
+        CHECK_EQUAL(2u, dispatcher.connect("user", "secret"));
+        stopped.stop();
+        CHECK(LocalEngine(Reduction::Sum, Kernel::Scalar).calculate(data) == dispatcher.calculate(data, 3));
+        dispatcher.closeConnections();
+
+        vector<ServerStats> stats = dispatcher.getStats();
+        CHECK_EQUAL(0u, stats[0].vectors);
+        CHECK_EQUAL(30u, stats[1].vectors);
+        CHECK(stats[0].failures >= 1);
+    }
+
+    /**
+     * @brief Тест выброса TimeoutError, если ни один сервер не ответил в срок.
+     */
+    TEST(CheckThrowAllServersTimeout)
+    {
+        // Серверы принимают соединение, но ничего не отвечают
+        int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(listener, reinterpret_cast<struct sockaddr *>(&address), sizeof(address));
+        listen(listener, 4);
+        socklen_t length = sizeof(address);
+        getsockname(listener, reinterpret_cast<struct sockaddr *>(&address), &length);
+
+        vector<Endpoint> endpoints = {{"127.0.0.1", ntohs(address.sin_port)}, {"127.0.0.1", ntohs(address.sin_port)}};
+        Dispatcher dispatcher(endpoints);
+        SocketOptions options;
+        options.timeout = 100;
+        dispatcher.setSocketOptions(options);
+        CHECK_THROW(dispatcher.connect("user", "secret"), TimeoutError);
+        ::close(listener);
+    }
+}
+
+/**
+ * @brief Тесты для модуля LocalEngine.
+ */
+SUITE(LocalEngineTests)
+{
+    /**
+     * @brief Тест свёртки векторов из входного файла.
+     */
+    TEST(CalculateInputTest)
+    {
+        DataHandler dataHandler("./config/vclient.conf", "./input.bin", "./output.bin");
+        LocalEngine engine(Reduction::Sum, Kernel::Scalar);
+        vector<double> result = engine.calculate(dataHandler.readData());
+        CHECK_EQUAL(3, result.size());
+        CHECK_CLOSE(47098.42, result[0], 0.01);
+        CHECK_CLOSE(-6960.24, result[2], 0.01);
+    }
+
+    /**
+     * @brief Тест совпадения векторных вариантов свёртки с последовательным.
+     */
+    TEST(KernelsMatchScalarTest)
+    {
+        vector<double> values;
+        for (int i = 0; i < 37; ++i)
+        {
+            values.push_back(1.0 + (i % 7) * 0.125 - (i % 3) * 0.5);
+        }
+
+        const Reduction reductions[] = {Reduction::Sum, Reduction::Product, Reduction::Mean, Reduction::SumOfSquares};
+        const Kernel kernels[] = {Kernel::Sse2, Kernel::Avx2};
+        for (Reduction reduction : reductions)
+        {
+            LocalEngine scalar(reduction, Kernel::Scalar);
+            double expected = scalar.reduce(values.data(), values.size());
+            for (Kernel kernel : kernels)
+            {
+                if (!LocalEngine::isSupported(kernel))
+                {
+                    continue;
+                }
+                LocalEngine engine(reduction, kernel);
+                CHECK_CLOSE(expected, engine.reduce(values.data(), values.size()), 1e-9);
+            }
+        }
+    }
+
+    /**
+     * @brief Тест свёртки пустого вектора.
+     */
+    TEST(EmptyVectorTest)
+    {
+        CHECK_EQUAL(0.0, LocalEngine(Reduction::Sum).reduce(nullptr, 0));
+        CHECK_EQUAL(1.0, LocalEngine(Reduction::Product).reduce(nullptr, 0));
+        CHECK_EQUAL(0.0, LocalEngine(Reduction::Mean).reduce(nullptr, 0));
+    }
+
+    /**
+     * @brief Тест подсчёта несовпадающих результатов.
+     */
+    TEST(CountMismatchesTest)
     {
-        DataHandler dataHandler("./config/invalid.conf", "./input.bin", "./output.bin");
-        CHECK_THROW(dataHandler.loadConfig(), RuntimeError);
+        CHECK_EQUAL(0, CountMismatches({1.0, 1e6}, {1.0 + 1e-12, 1e6 * (1 + 1e-12)}));
+        CHECK_EQUAL(1, CountMismatches({1.0, 2.0}, {1.0, 2.5}));
+        CHECK_EQUAL(2, CountMismatches({1.0}, {1.0, 2.0}));
+    }
+
+    /**
+     * @brief Тест выброса исключения при неизвестной операции свёртки.
+     */
+    TEST(CheckThrowUnknownReduction)
+    {
+        CHECK_THROW(ParseReduction("median"), RuntimeError);
+        CHECK_THROW(ParseKernel("neon"), RuntimeError);
     }
 }
 
 /**
- * @brief Тесты для модуля Client.
+ * @brief Тесты для модуля InputValidator.
  */
-SUITE(ClientTests)
+SUITE(InputValidatorTests)
 {
     /**
-     * @brief Тест конструктора класса Client.
+     * @brief Тест совпадения статистики векторных вариантов с последовательным проходом.
      */
-    TEST(ConstructorTest)
+    TEST(KernelsMatchScalarTest)
     {
-        Client client("127.0.0.1", 33333);
-        CHECK_EQUAL("127.0.0.1", client.getAddress());
-        CHECK_EQUAL(33333, client.getPort());
+        vector<double> values;
+        for (int i = 0; i < 37; ++i)
+        {
+            values.push_back((i % 11) * 0.5 - 2.0);
+        }
+        values[5] = NAN;
+        values[36] = -HUGE_VAL;
+
+        VectorStats expected = InputValidator(Kernel::Scalar).scan(values.data(), values.size());
+        CHECK_EQUAL(37u, expected.count);
+        CHECK_EQUAL(2u, expected.non_finite);
+        CHECK_EQUAL(-HUGE_VAL, expected.min);
+        CHECK_EQUAL(3.0, expected.max);
+
+        const Kernel kernels[] = {Kernel::Sse2, Kernel::Avx2};
+        for (Kernel kernel : kernels)
+        {
+            if (!LocalEngine::isSupported(kernel))
+            {
+                continue;
+            }
+            VectorStats stats = InputValidator(kernel).scan(values.data(), values.size());
+            CHECK_EQUAL(expected.count, stats.count);
+            CHECK_EQUAL(expected.non_finite, stats.non_finite);
+            CHECK_EQUAL(expected.min, stats.min);
+            CHECK_EQUAL(expected.max, stats.max);
+
+            // Без нечисловых значений суммы модулей совпадают с точностью до порядка сложения
+            VectorStats a = InputValidator(Kernel::Scalar).scan(values.data(), 36);
+            VectorStats b = InputValidator(kernel).scan(values.data(), 36);
+            CHECK_CLOSE(a.magnitude, b.magnitude, 1e-9);
+        }
+    }
+
+    /**
+     * @brief Тест обнаружения NaN, бесконечностей и риска переполнения.
+     */
+    TEST(CheckThrowInvalidInput)
+    {
+        InputValidator validator;
+        ValidationReport clean = validator.validate(VectorBatch{{1.0, -2.5}, {}, {3.0}});
+        CHECK_EQUAL(SIZE_MAX, clean.first_invalid);
+        CHECK_EQUAL(-2.5, clean.vectors[0].min);
+        CHECK_EQUAL(0u, clean.vectors[1].count);
+        CheckValidation(clean, ElementType::Double);
+
+        ValidationReport bad = validator.validate(VectorBatch{{1.0}, {2.0, NAN}, {HUGE_VAL}, {1e308, 1e308}});
+        CHECK_EQUAL(2u, bad.non_finite);
+        CHECK_EQUAL(1u, bad.overflow);
+        CHECK_EQUAL(1u, bad.first_invalid);
+        CHECK_THROW(CheckValidation(bad, ElementType::Double), RuntimeError);
+
+        ValidationReport narrow = validator.validate(BasicVectorBatch<int16_t>{{30000, -100}, {30000, 30000}});
+        CHECK_EQUAL(1u, narrow.overflow);
+        CHECK_EQUAL(1u, narrow.first_invalid);
+        CHECK_EQUAL(30000.0, narrow.vectors[1].max);
+    }
+}
+
+/**
+ * @brief Тесты для модуля ResultCache.
+ */
+SUITE(ResultCacheTests)
+{
+    /**
+     * @brief Тест зависимости ключа от содержимого и длины вектора.
+     */
+    TEST(HashVectorTest)
+    {
+        vector<double> a = {1.0, 2.0, 3.0};
+        vector<double> b = {1.0, 2.0, 3.0};
+        vector<double> c = {1.0, 3.0, 2.0};
+        CHECK(HashVector(a.data(), a.size()) == HashVector(b.data(), b.size()));
+        CHECK(!(HashVector(a.data(), a.size()) == HashVector(c.data(), c.size())));
+        CHECK(!(HashVector(a.data(), 2) == HashVector(a.data(), 3)));
+        CHECK(!(HashVector(a.data(), a.size(), 1) == HashVector(a.data(), a.size(), 2)));
+    }
+
+    /**
+     * @brief Тест отправки только отсутствующих в кэше векторов и сохранения кэша между запусками.
+     */
+    TEST(CalculateCachedTest)
+    {
+        remove("./cache.bin");
+        VectorBatch data = {{1.0, 2.0}, {3.0}, {1.0, 2.0}};
+        size_t sent = 0;
+        auto calculate = [&](const VectorBatch &vectors) {
+            sent += vectors.size();
+            return LocalEngine(Reduction::Sum, Kernel::Scalar).calculate(vectors);
+        };
+
+        ResultCache first("./cache.bin", "double/MD5");
+        CHECK_EQUAL(0, first.load());
+        size_t hits = 0;
+        vector<double> result = CalculateCached(first, data, calculate, hits);
+        first.save();
+        CHECK_EQUAL(0, hits);
+        CHECK_EQUAL(3, sent);
+        CHECK_EQUAL(3.0, result[2]);
+
+        // Оборванная запись в конце файла не должна сдвигать следующие записи
+        ofstream tail("./cache.bin", ios::binary | ios::app);
+        tail.write("garbage", 7);
+        tail.close();
+
+        ResultCache second("./cache.bin", "double/MD5");
+        CHECK_EQUAL(2, second.load());
+        data.push_back({4.0});
+        result = CalculateCached(second, data, calculate, hits);
+        second.save();
+        CHECK_EQUAL(3, hits);
+        CHECK_EQUAL(4, sent);
+        CHECK_EQUAL(3.0, result[1]);
+        CHECK_EQUAL(4.0, result[3]);
+
+        ResultCache third("./cache.bin", "double/MD5");
+        CHECK_EQUAL(3, third.load());
+        CalculateCached(third, data, calculate, hits);
+        CHECK_EQUAL(4, hits);
+        CHECK_EQUAL(4, sent);
+
+        ResultCache other("./cache.bin", "int16/MD5");
+        other.load();
+        CalculateCached(other, data, calculate, hits);
+        CHECK_EQUAL(0, hits);
+        remove("./cache.bin");
+    }
+
+    /**
+     * @brief Тест выброса исключения при загрузке файла, не являющегося кэшем.
+     */
+    TEST(CheckThrowNotCache)
+    {
+        ResultCache cache("./input.bin", "double/MD5");
+        CHECK_THROW(cache.load(), RuntimeError);
+    }
+}
+
+/**
+ * @brief Тесты для модуля Deduplicator.
+ */
+SUITE(DeduplicatorTests)
+{
+    /**
+     * @brief Тест исключения повторов и раздачи результатов по исходным позициям.
+     */
+    TEST(UniqueAndExpandTest)
+    {
+        VectorBatch data = {{1.0, 2.0}, {}, {1.0, 2.0}, {2.0, 1.0}, {}, {1.0, 2.0}};
+        Deduplicator dedup(data);
+        CHECK_EQUAL(6, dedup.getTotalCount());
+        CHECK_EQUAL(3, dedup.getUniqueCount());
+        CHECK_CLOSE(2.0, dedup.getRatio(), 1e-12);
+
+        VectorBatch unique = dedup.unique();
+        CHECK_EQUAL(3, unique.size());
+        CHECK_EQUAL(2.0, unique[2][0]);
+
+        vector<double> result = dedup.expand({10.0, 20.0, 30.0});
+        CHECK_EQUAL(6, result.size());
+        CHECK_EQUAL(10.0, result[2]);
+        CHECK_EQUAL(20.0, result[4]);
+        CHECK_EQUAL(30.0, result[3]);
+        CHECK_EQUAL(10.0, result[5]);
+    }
+
+    /**
+     * @brief Тест выброса исключения при неверном количестве результатов.
+     */
+    TEST(CheckThrowExpandSizeMismatch)
+    {
+        VectorBatch data = {{1.0}, {1.0}};
+        Deduplicator dedup(data);
+        CHECK_THROW(dedup.expand({1.0, 2.0}), RuntimeError);
+    }
+}
+
+/**
+ * @brief Тесты для модуля Checkpoint.
+ */
+SUITE(CheckpointTests)
+{
+    /**
+     * @brief Тест сохранения диапазонов и их загрузки с отбрасыванием повреждённого хвоста.
+     */
+    TEST(RecordAndLoadTest)
+    {
+        remove("./output.bin.ckpt");
+        VectorBatch data = {{1.0, 2.0}, {3.0}, {4.0, 5.0, 6.0}, {7.0}, {8.0, 9.0}};
+        Checkpoint first("./output.bin.ckpt", data);
+        CHECK_EQUAL(0u, first.load());
+        first.record(0, {1.0, 2.0});
+        first.record(4, {5.0});
+        CHECK_EQUAL(3u, first.getCompleted());
+
+        // Оборванная запись в конце файла
+        ofstream tail("./output.bin.ckpt", ios::binary | ios::app);
+        uint64_t range[2] = {2, 2};
+        tail.write(reinterpret_cast<const char *>(range), sizeof(range));
+        tail.close();
+
+        Checkpoint second("./output.bin.ckpt", data);
+        CHECK_EQUAL(3u, second.load());
+        CHECK_EQUAL(2.0, second.getResults()[1]);
+        CHECK_EQUAL(5.0, second.getResults()[4]);
+        vector<pair<size_t, size_t>> pending = second.pending(1);
+        CHECK_EQUAL(2u, pending.size());
+        CHECK_EQUAL(2u, pending[0].first);
+        CHECK_EQUAL(4u, pending[1].second);
+        second.record(2, {3.0, 4.0});
+        CHECK(second.pending(2).empty());
+
+        Checkpoint third("./output.bin.ckpt", data);
+        CHECK_EQUAL(5u, third.load());
+
+        // Другие данные с тем же количеством векторов и элементов: контрольная точка отбрасывается
+        VectorBatch other_data = {{1.0, 2.0}, {3.0}, {4.0, 5.0, 6.5}, {7.0}, {8.0, 9.0}};
+        Checkpoint other("./output.bin.ckpt", other_data);
+        CHECK_EQUAL(0u, other.load());
+        CHECK_EQUAL(0u, Checkpoint("./output.bin.ckpt", data).load());
+        CHECK_THROW(Checkpoint("./input.bin", data).load(), RuntimeError);
+        third.remove();
+        CHECK(!ifstream("./output.bin.ckpt").is_open());
+    }
+
+    /**
+     * @brief Тест продолжения вычислений с незавершённой части после недоступности сервера.
+     */
+    TEST(CalculateResumableTest)
+    {
+        remove("./output.bin.ckpt");
+        VectorBatch data = {{1.0}, {2.0, 3.0}, {}, {4.0}, {5.0, 6.0}};
+        LoopbackServer server("secret");
+        server.start();
+        Client client("127.0.0.1", server.getPort());
+        client.connectToServer();
+        client.authenticate("user", "secret");
+
+        Checkpoint checkpoint("./output.bin.ckpt", data);
+        checkpoint.load();
+        checkpoint.record(0, {1.0, 5.0});
+        vector<double> result = CalculateResumable(client, data, checkpoint, 2, 1);
+        CHECK_EQUAL(5u, result.size());
+        CHECK_EQUAL(5.0, result[1]);
+        CHECK_EQUAL(11.0, result[4]);
+        CHECK_EQUAL(2u, server.getRequests());
+
+        // Сервер недоступен: после всех попыток выбрасывается исключение, сохранённое остаётся
+        server.stop();
+        Checkpoint restarted("./output.bin.ckpt", data);
+        CHECK_EQUAL(5u, restarted.load());
+        Checkpoint pending("./output.bin.ckpt.new", data);
+        pending.load();
+        CHECK_THROW(CalculateResumable(client, data, pending, 2, 1), RuntimeError);
+        CHECK(!client.isConnected());
+
+        // Срок запуска истекает во время повторов: пауза укорачивается, ошибка сообщается как таймаут
+        client.setJobDeadline(Deadline(chrono::milliseconds(250)));
+        auto started = chrono::steady_clock::now();
+        CHECK_THROW(CalculateResumable(client, data, pending, 2, 100), TimeoutError);
+        CHECK(chrono::steady_clock::now() - started < chrono::milliseconds(1000));
+        restarted.remove();
+        pending.remove();
+    }
+}
+
+/**
+ * @brief Тесты для модулей LatencyStats и LoopbackServer.
+ */
+SUITE(BenchTests)
+{
+    /**
+     * @brief Тест расчёта перцентилей по ближайшему рангу.
+     */
+    TEST(LatencyStatsPercentiles)
+    {
+        LatencyStats stats;
+        for (int i = 100; i >= 1; --i)
+        {
+            stats.add(i);
+        }
+        CHECK_EQUAL(100u, stats.count());
+        CHECK_CLOSE(50.0, stats.percentile(50), 1e-12);
+        CHECK_CLOSE(99.0, stats.percentile(99), 1e-12);
+        CHECK_CLOSE(100.0, stats.percentile(100), 1e-12);
+        CHECK_CLOSE(50.5, stats.mean(), 1e-12);
+    }
+
+    /**
+     * @brief Тест вычисления через локальный сервер с аутентификацией.
+     */
+    TEST(LoopbackServerCalculate)
+    {
+        LoopbackServer server("secret");
+        server.start();
+
+        Client client("127.0.0.1", server.getPort());
+        client.connectToServer();
+        client.authenticate("user", "secret");
+        VectorBatch data = {{1.0, 2.0}, {}, {3.5}};
+        vector<double> result = client.submit(data, 0, data.size());
+        CHECK_EQUAL(3u, result.size());
+        CHECK_CLOSE(3.0, result[0], 1e-12);
+        CHECK_CLOSE(0.0, result[1], 1e-12);
+        CHECK_CLOSE(3.5, result[2], 1e-12);
+        client.closeConnection();
+
+        Client tuned("127.0.0.1", server.getPort());
+        SocketOptions options;
+        options.recv_buffer = 1 << 16;
+        tuned.setSocketOptions(options);
+        tuned.connectToServer();
+        int nodelay = 0;
+        socklen_t length = sizeof(nodelay);
+        getsockopt(tuned.getSocket(), IPPROTO_TCP, TCP_NODELAY, &nodelay, &length);
+        CHECK(nodelay != 0);
+        tuned.closeConnection();
+
+        Client intruder("127.0.0.1", server.getPort());
+        intruder.connectToServer();
+        CHECK_THROW(intruder.authenticate("user", "wrong"), RuntimeError);
+        intruder.closeConnection();
+        server.stop();
+        CHECK_EQUAL(1u, server.getRequests());
+    }
+
+    /**
+     * @brief Тест вычисления с элементами int32_t и float через локальный сервер.
+     */
+    TEST(LoopbackServerTypedCalculate)
+    {
+        LoopbackServer server("secret");
+        server.setElementType(ElementType::Int32);
+        server.start();
+
+        Client client("127.0.0.1", server.getPort());
+        client.connectToServer();
+        client.authenticate("user", "secret");
+        BasicVectorBatch<int32_t> data = {{1, 2, 3}, {}, {-40000, 5}};
+        vector<int32_t> result = client.submit(data, 0, data.size());
+        CHECK_EQUAL(3u, result.size());
+        CHECK_EQUAL(6, result[0]);
+        CHECK_EQUAL(0, result[1]);
+        CHECK_EQUAL(-39995, result[2]);
+        client.closeConnection();
+        server.stop();
+
+        LoopbackServer float_server("secret");
+        float_server.setElementType(ElementType::Float);
+        float_server.start();
+        Client float_client("127.0.0.1", float_server.getPort());
+        float_client.connectToServer();
+        float_client.authenticate("user", "secret");
+        BasicVectorBatch<float> float_data = {{0.5f, 0.25f}};
+        vector<float> float_result = float_client.submit(float_data, 0, float_data.size());
+        CHECK_EQUAL(1u, float_result.size());
+        CHECK_CLOSE(0.75f, float_result[0], 1e-6f);
+        float_client.closeConnection();
+        float_server.stop();
+    }
+
+    /**
+     * @brief Тест нескольких запросов в полёте в одной сессии.
+     */
+    TEST(LoopbackServerWindowedCalculate)
+    {
+        LoopbackServer server("secret");
+        server.start();
+        Client client("127.0.0.1", server.getPort());
+        client.connectToServer();
+        client.authenticate("user", "secret");
+
+        VectorBatch data;
+        for (size_t i = 0; i < 50; ++i)
+        {
+            data.push_back({i * 1.0, 1.0});
+        }
+        vector<double> expected = LocalEngine(Reduction::Sum, Kernel::Scalar).calculate(data);
+        CHECK(expected == client.calculateWindowed(data, 7, 3));
+        CHECK(expected == client.calculateWindowed(data, 20, 16));
+        CHECK(expected == client.calculate(data));
+        client.closeConnection();
+        server.stop();
+        CHECK_EQUAL(8u + 3u + 1u, server.getRequests());
+        CHECK_EQUAL(1u, server.getConnections());
+    }
+
+    /**
+     * @brief Тест обмена через io_uring с запросом из нескольких сообщений.
+     */
+    TEST(LoopbackServerUringCalculate)
+    {
+        LoopbackServer server("secret");
+        server.start();
+
+        Client client("127.0.0.1", server.getPort());
+        client.setBatchLimit(3);
+        client.setIoBackend(IoBackend::Uring);
+        CHECK(client.getIoBackend() == (IoRing::isSupported() ? IoBackend::Uring : IoBackend::Blocking));
+        client.connectToServer();
+        client.authenticate("user", "secret");
+
+        // Запрос больше кольца, чтобы отправка шла в несколько раундов
+        VectorBatch data;
+        for (size_t i = 0; i < 500; ++i)
+        {
+            data.push_back({i * 1.0, 0.5});
+        }
+        for (int round = 0; round < 2; ++round)
+        {
+            vector<double> result = client.submit(data, 0, data.size());
+            CHECK_EQUAL(data.size(), result.size());
+            CHECK_CLOSE(499.5, result.back(), 1e-12);
+        }
+        client.closeConnection();
+        server.stop();
+        CHECK_EQUAL(2u, server.getRequests());
+    }
+}
+
+/**
+ * @brief Тесты для модуля Metrics.
+ */
+SUITE(MetricsTests)
+{
+    /**
+     * @brief Тест накопления времени фаз и счётчиков.
+     */
+    TEST(PhasesAndCounters)
+    {
+        Metrics metrics;
+        {
+            PhaseTimer timer("read", metrics);
+        }
+        metrics.addPhase("read", 0.5);
+        metrics.count(Counter::BytesSent, 100);
+        metrics.count(Counter::SendCalls);
+        CHECK_EQUAL(2u, metrics.getPhaseCalls("read"));
+        CHECK(metrics.getPhaseTime("read") >= 0.5);
+        CHECK_EQUAL(0u, metrics.getPhaseCalls("write"));
+        CHECK_EQUAL(100u, metrics.get(Counter::BytesSent));
+        CHECK_EQUAL(1u, metrics.get(Counter::SendCalls));
+        CHECK(Metrics::getResourceUsage().peak_rss > 0);
+    }
+
+    /**
+     * @brief Тест экспорта в форматах JSON и Prometheus.
+     */
+    TEST(Export)
+    {
+        Metrics metrics;
+        metrics.addPhase("connect", 0.25);
+        metrics.count(Counter::BytesReceived, 42);
+
+        string json = metrics.toJson();
+        CHECK(json.find("\"connect\": {\"seconds\": 0.25, \"calls\": 1}") != string::npos);
+        CHECK(json.find("\"bytes_received\": 42") != string::npos);
+        CHECK(json.find("\"peak_rss_bytes\"") != string::npos);
+
+        string prom = metrics.toPrometheus();
+        CHECK(prom.find("vclient_phase_seconds_total{phase=\"connect\"} 0.25\n") != string::npos);
+        CHECK(prom.find("vclient_bytes_received_total 42\n") != string::npos);
+        CHECK_THROW(metrics.save("/tmp/metrics.txt", "xml"), RuntimeError);
+    }
+}
+
+/**
+ * @brief Тесты для модуля Logger.
+ */
+SUITE(LoggerTests)
+{
+    /**
+     * @brief Тест фильтрации по уровню и порядка вывода.
+     */
+    TEST(LevelsTest)
+    {
+        ostringstream out, err;
+        Logger logger(out, err, 2);
+        LogLine(LogLevel::Info, logger) << "first " << 1;
+        LogLine(LogLevel::Debug, logger) << "hidden";
+        LogLine(LogLevel::Error, logger) << "failure";
+        logger.setLevel(LogLevel::Debug);
+        for (int i = 0; i < 5; ++i)
+        {
+            LogLine(LogLevel::Debug, logger) << i;
+        }
+        logger.flush();
+        CHECK_EQUAL("[LOG] first 1\n[DBG] 0\n[DBG] 1\n[DBG] 2\n[DBG] 3\n[DBG] 4\n", out.str());
+        CHECK_EQUAL("[ERR] failure\n", err.str());
+    }
+
+    /**
+     * @brief Тест режима quiet и разбора уровней.
+     */
+    TEST(QuietTest)
+    {
+        ostringstream out, err;
+        Logger logger(out, err);
+        logger.setLevel(ParseLogLevel("quiet"));
+        CHECK(!logger.enabled(LogLevel::Info));
+        LogLine(LogLevel::Info, logger) << "hidden";
+        LogLine(LogLevel::Error, logger) << "shown";
+        logger.flush();
+        CHECK_EQUAL("", out.str());
+        CHECK_EQUAL("[ERR] shown\n", err.str());
+        CHECK_THROW(ParseLogLevel("loud"), RuntimeError);
     }
 }
 
@@ -130,6 +1523,18 @@ SUITE(TerminalTests)
         CHECK_EQUAL("input.bin", terminal.getInputPath());
         CHECK_EQUAL("output.bin", terminal.getOutputPath());
         CHECK_EQUAL("custom.conf", terminal.getConfigPath());
+        CHECK(!terminal.isZeroCopy());
+    }
+
+    /**
+     * @brief Тест разбора флага прямой передачи входного файла.
+     */
+    TEST(ParseArgs_ZeroCopyTest)
+    {
+        Terminal terminal;
+        const char *argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "--zero-copy"};
+        terminal.parseArgs(6, const_cast<char **>(argv));
+        CHECK(terminal.isZeroCopy());
     }
 
     /**
@@ -192,6 +1597,223 @@ SUITE(TerminalTests)
         CHECK_THROW(terminal.parseArgs(2, const_cast<char **>(argv)), RuntimeError);
     }
 
+    /**
+     * @brief Тест разбора параметров потокового режима.
+     */
+    TEST(ParseArgs_StreamTest)
+    {
+        Terminal terminal;
+        const char *argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "-s", "--chunk-size", "64"};
+        terminal.parseArgs(8, const_cast<char **>(argv));
+        CHECK(terminal.isStreaming());
+        CHECK_EQUAL(64, terminal.getChunkSize());
+        CHECK_EQUAL(1024, terminal.getSendBatch());
+    }
+
+    /**
+     * @brief Тест разбора количества сессий.
+     */
+    TEST(ParseArgs_SessionsTest)
+    {
+        Terminal terminal;
+        const char *argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "-j", "4"};
+        terminal.parseArgs(7, const_cast<char **>(argv));
+        CHECK_EQUAL(4, terminal.getSessions());
+    }
+
+    /**
+     * @brief Тест разбора пакетного режима без входного и выходного файлов.
+     */
+    TEST(ParseArgs_ManifestTest)
+    {
+        Terminal terminal;
+        const char *argv[] = {"program", "-m", "jobs.txt"};
+        terminal.parseArgs(3, const_cast<char **>(argv));
+        CHECK_EQUAL("jobs.txt", terminal.getManifestPath());
+        CHECK_EQUAL("", terminal.getInputPath());
+    }
+
+    /**
+     * @brief Тест разбора списка серверов.
+     */
+    TEST(ParseArgs_EndpointsTest)
+    {
+        Terminal terminal;
+        const char *argv[] = {"program", "-a", "10.0.0.1,10.0.0.2:4000", "-p", "5000", "-i", "input.bin", "-o", "output.bin"};
+        terminal.parseArgs(9, const_cast<char **>(argv));
+        vector<Endpoint> endpoints = terminal.getEndpoints();
+        CHECK_EQUAL(2, endpoints.size());
+        CHECK_EQUAL("10.0.0.1", endpoints[0].address);
+        CHECK_EQUAL(5000, endpoints[0].port);
+        CHECK_EQUAL("10.0.0.2", endpoints[1].address);
+        CHECK_EQUAL(4000, endpoints[1].port);
+        CHECK_EQUAL("10.0.0.1", terminal.getAddress());
+    }
+
+    /**
+     * @brief Тест выброса исключения при неверном порте в списке серверов.
+     */
+    TEST(CheckThrowInvalidEndpointPort)
+    {
+        Terminal terminal;
+        const char *argv[] = {"program", "-a", "10.0.0.1:0", "-i", "input.bin", "-o", "output.bin"};
+        CHECK_THROW(terminal.parseArgs(7, const_cast<char **>(argv)), RuntimeError);
+    }
+
+    /**
+     * @brief Тест разбора параметров локальных вычислений.
+     */
+    TEST(ParseArgs_LocalTest)
+    {
+        Terminal terminal;
+        const char *argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "-L", "--op", "sumsq", "--kernel", "scalar"};
+        terminal.parseArgs(10, const_cast<char **>(argv));
+        CHECK(terminal.isLocal());
+        CHECK(!terminal.isVerify());
+        CHECK_EQUAL("sumsq", terminal.getReduction());
+        CHECK_EQUAL("scalar", terminal.getKernel());
+    }
+
+    /**
+     * @brief Тест выброса исключения при одновременном выборе несовместимых режимов.
+     */
+    TEST(CheckThrowZeroCopyWithStream)
+    {
+        Terminal terminal;
+        const char *argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "-z", "-s"};
+        CHECK_THROW(terminal.parseArgs(7, const_cast<char **>(argv)), RuntimeError);
+    }
+
+    /**
+     * @brief Тест выбора типа элементов и его совместимости с режимами.
+     */
+    TEST(ElementTypeTest)
+    {
+        Terminal terminal;
+        CHECK_EQUAL("double", terminal.getElementType());
+        const char *argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "-T", "int32"};
+        terminal.parseArgs(7, const_cast<char **>(argv));
+        CHECK_EQUAL("int32", terminal.getElementType());
+
+        Terminal unknown;
+        const char *unknown_argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "--type", "int8"};
+        CHECK_THROW(unknown.parseArgs(7, const_cast<char **>(unknown_argv)), RuntimeError);
+
+        Terminal sessions;
+        const char *sessions_argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "-T", "float", "-j", "2"};
+        CHECK_THROW(sessions.parseArgs(9, const_cast<char **>(sessions_argv)), RuntimeError);
+    }
+
+    /**
+     * @brief Тест параметров контрольных точек и их совместимости с режимами.
+     */
+    TEST(CheckpointOptionsTest)
+    {
+        Terminal terminal;
+        CHECK(!terminal.isCheckpoint());
+        CHECK_EQUAL(3u, terminal.getRetries());
+        const char *argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "--checkpoint", "--retries", "7"};
+        terminal.parseArgs(8, const_cast<char **>(argv));
+        CHECK(terminal.isCheckpoint());
+        CHECK_EQUAL(7u, terminal.getRetries());
+
+        Terminal stream;
+        const char *stream_argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "--checkpoint", "-s"};
+        CHECK_THROW(stream.parseArgs(7, const_cast<char **>(stream_argv)), RuntimeError);
+    }
+
+    /**
+     * @brief Тест размера окна запросов и его совместимости с режимами.
+     */
+    TEST(WindowTest)
+    {
+        Terminal terminal;
+        CHECK_EQUAL(1u, terminal.getWindow());
+        const char *argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "--window", "4"};
+        terminal.parseArgs(7, const_cast<char **>(argv));
+        CHECK_EQUAL(4u, terminal.getWindow());
+
+        Terminal zero;
+        const char *zero_argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "--window", "0"};
+        CHECK_THROW(zero.parseArgs(7, const_cast<char **>(zero_argv)), RuntimeError);
+
+        Terminal sessions;
+        const char *sessions_argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "--window", "4", "-j", "2"};
+        CHECK_THROW(sessions.parseArgs(9, const_cast<char **>(sessions_argv)), RuntimeError);
+    }
+
+    /**
+     * @brief Тест проверки входных данных перед отправкой.
+     */
+    TEST(ValidateTest)
+    {
+        Terminal terminal;
+        CHECK(!terminal.isValidate());
+        const char *argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "--validate"};
+        terminal.parseArgs(6, const_cast<char **>(argv));
+        CHECK(terminal.isValidate());
+
+        Terminal zero_copy;
+        const char *zero_copy_argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "--validate", "-z"};
+        CHECK_THROW(zero_copy.parseArgs(7, const_cast<char **>(zero_copy_argv)), RuntimeError);
+    }
+
+    /**
+     * @brief Тест выбора способа ввода-вывода.
+     */
+    TEST(IoBackendTest)
+    {
+        Terminal terminal;
+        CHECK_EQUAL("blocking", terminal.getIoBackend());
+        const char *argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "--io", "uring"};
+        terminal.parseArgs(7, const_cast<char **>(argv));
+        CHECK_EQUAL("uring", terminal.getIoBackend());
+
+        Terminal unknown;
+        const char *unknown_argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "--io", "aio"};
+        CHECK_THROW(unknown.parseArgs(7, const_cast<char **>(unknown_argv)), RuntimeError);
+    }
+
+    /**
+     * @brief Тест разбора параметров сокета.
+     */
+    TEST(SocketOptionsTest)
+    {
+        Terminal terminal;
+        const char *argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "--no-nodelay", "--sndbuf", "65536", "--busy-poll", "50"};
+        terminal.parseArgs(10, const_cast<char **>(argv));
+        SocketOptions options = terminal.getSocketOptions();
+        CHECK(!options.nodelay);
+        CHECK(options.quickack);
+        CHECK_EQUAL(65536, options.send_buffer);
+        CHECK_EQUAL(0, options.recv_buffer);
+        CHECK_EQUAL(50, options.busy_poll);
+        CHECK_EQUAL(0, options.timeout);
+        CHECK_EQUAL(0u, terminal.getDeadline());
+
+        Terminal limited;
+        const char *limited_argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "--timeout", "250", "--deadline", "60000"};
+        limited.parseArgs(9, const_cast<char **>(limited_argv));
+        CHECK_EQUAL(250, limited.getSocketOptions().timeout);
+        CHECK_EQUAL(60000u, limited.getDeadline());
+    }
+
+    /**
+     * @brief Тест выбора формата метрик по расширению файла.
+     */
+    TEST(MetricsFormatFromExtension)
+    {
+        Terminal terminal;
+        const char *argv[] = {"program", "-i", "input.bin", "-o", "output.bin", "--metrics", "run.prom"};
+        terminal.parseArgs(7, const_cast<char **>(argv));
+        CHECK_EQUAL("run.prom", terminal.getMetricsPath());
+        CHECK_EQUAL("prometheus", terminal.getMetricsFormat());
+
+        Terminal other;
+        const char *bad[] = {"program", "-i", "input.bin", "-o", "output.bin", "--metrics-format", "xml"};
+        CHECK_THROW(other.parseArgs(7, const_cast<char **>(bad)), RuntimeError);
+    }
+
     /**
      * @brief Тест выброса исключения при отсутствии обязательных параметров.
      */
@@ -0,0 +1,259 @@
+#include "uring.h"
+#include "metrics.h"
+#include <cstring>
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+// Системные вызовы io_uring без обёрток libc
+static int SysSetup(unsigned entries, struct io_uring_params *params)
+{
+    return syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int SysEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+    return syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+}
+
+static int SysRegister(int fd, unsigned opcode, const void *arg, unsigned count)
+{
+    return syscall(__NR_io_uring_register, fd, opcode, arg, count);
+}
+
+// Функция для разбора названия способа ввода-вывода
+IoBackend ParseIoBackend(const string &name)
+{
+    if (name == "blocking")
+        return IoBackend::Blocking;
+    if (name == "uring")
+        return IoBackend::Uring;
+    throw RuntimeError("Unknown I/O backend: " + name, __func__);
+}
+
+// Конструктор
+IoRing::IoRing(unsigned entries)
+    : fd_(-1), entries_(0), ring_(MAP_FAILED), ring_size_(0), cq_ring_(MAP_FAILED), cq_ring_size_(0),
+      sqes_(static_cast<struct io_uring_sqe *>(MAP_FAILED)), sqes_size_(0), pending_(0)
+{
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    this->fd_ = SysSetup(entries, &params);
+    if (this->fd_ < 0)
+    {
+        throw RuntimeError("Failed to create io_uring: " + string(strerror(errno)), __func__);
+    }
+    this->entries_ = params.sq_entries;
+
+    // Очереди отправки и завершений отображаются одним блоком, если ядро это поддерживает
+    this->ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap)
+    {
+        this->ring_size_ = max(this->ring_size_, cq_size);
+    }
+    this->ring_ = mmap(nullptr, this->ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->fd_, IORING_OFF_SQ_RING);
+    if (this->ring_ != MAP_FAILED && !single_mmap)
+    {
+        this->cq_ring_size_ = cq_size;
+        this->cq_ring_ = mmap(nullptr, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->fd_, IORING_OFF_CQ_RING);
+    }
+    this->sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes = mmap(nullptr, this->sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->fd_, IORING_OFF_SQES);
+    this->sqes_ = static_cast<struct io_uring_sqe *>(sqes);
+    if (this->ring_ == MAP_FAILED || (!single_mmap && this->cq_ring_ == MAP_FAILED) || sqes == MAP_FAILED)
+    {
+        int error = errno;
+        release();
+        throw RuntimeError("Failed to map io_uring queues: " + string(strerror(error)), __func__);
+    }
+
+    char *sq = static_cast<char *>(this->ring_);
+    char *cq = single_mmap ? sq : static_cast<char *>(this->cq_ring_);
+    this->sq_head_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    this->sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    this->sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    this->sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    this->cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    this->cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    this->cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    this->cqes_ = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+}
+
+IoRing::~IoRing()
+{
+    release();
+}
+
+// Метод для освобождения очередей и дескриптора
+void IoRing::release()
+{
+    if (this->sqes_ != MAP_FAILED)
+    {
+        munmap(this->sqes_, this->sqes_size_);
+        this->sqes_ = static_cast<struct io_uring_sqe *>(MAP_FAILED);
+    }
+    if (this->cq_ring_ != MAP_FAILED)
+    {
+        munmap(this->cq_ring_, this->cq_ring_size_);
+        this->cq_ring_ = MAP_FAILED;
+    }
+    if (this->ring_ != MAP_FAILED)
+    {
+        munmap(this->ring_, this->ring_size_);
+        this->ring_ = MAP_FAILED;
+    }
+    if (this->fd_ >= 0)
+    {
+        ::close(this->fd_);
+        this->fd_ = -1;
+    }
+}
+
+// Метод для проверки доступности io_uring
+bool IoRing::isSupported()
+{
+    static const bool supported = []() {
+        try
+        {
+            IoRing probe(1);
+            return true;
+        }
+        catch (const RuntimeError &)
+        {
+            return false;
+        }
+    }();
+    return supported;
+}
+
+unsigned IoRing::getCapacity() const
+{
+    return this->entries_;
+}
+
+// Метод для регистрации буферов
+void IoRing::registerBuffers(const vector<struct iovec> &buffers)
+{
+    if (SysRegister(this->fd_, IORING_REGISTER_BUFFERS, buffers.data(), buffers.size()) < 0)
+    {
+        throw RuntimeError("Failed to register io_uring buffers: " + string(strerror(errno)), __func__);
+    }
+}
+
+// Метод для получения свободной записи очереди отправки
+struct io_uring_sqe *IoRing::nextSqe()
+{
+    const unsigned head = __atomic_load_n(this->sq_head_, __ATOMIC_ACQUIRE);
+    const unsigned tail = *this->sq_tail_;
+    if (tail - head >= this->entries_)
+    {
+        throw RuntimeError("io_uring submission queue is full", __func__);
+    }
+
+    const unsigned index = tail & *this->sq_mask_;
+    struct io_uring_sqe *sqe = &this->sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    this->sq_array_[index] = index;
+    __atomic_store_n(this->sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    ++this->pending_;
+    return sqe;
+}
+
+// Методы для постановки операций в очередь
+void IoRing::prepareRead(int fd, void *dest, size_t size, uint64_t offset, uint64_t user_data)
+{
+    struct io_uring_sqe *sqe = nextSqe();
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(dest);
+    sqe->len = size;
+    sqe->off = offset;
+    sqe->user_data = user_data;
+}
+
+void IoRing::prepareReadFixed(int fd, void *dest, size_t size, uint64_t offset, uint16_t buffer, uint64_t user_data)
+{
+    struct io_uring_sqe *sqe = nextSqe();
+    sqe->opcode = IORING_OP_READ_FIXED;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(dest);
+    sqe->len = size;
+    sqe->off = offset;
+    sqe->buf_index = buffer;
+    sqe->user_data = user_data;
+}
+
+void IoRing::prepareSendmsg(int socket, const struct msghdr *msg, int flags, bool link, uint64_t user_data)
+{
+    struct io_uring_sqe *sqe = nextSqe();
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = socket;
+    sqe->addr = reinterpret_cast<uint64_t>(msg);
+    sqe->len = 1;
+    sqe->msg_flags = flags;
+    sqe->flags = link ? IOSQE_IO_LINK : 0;
+    sqe->user_data = user_data;
+}
+
+void IoRing::prepareRecv(int socket, void *dest, size_t size, int flags, uint64_t user_data)
+{
+    struct io_uring_sqe *sqe = nextSqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = socket;
+    sqe->addr = reinterpret_cast<uint64_t>(dest);
+    sqe->len = size;
+    sqe->msg_flags = flags;
+    sqe->user_data = user_data;
+}
+
+// Метод для передачи операций ядру
+void IoRing::submit(unsigned wait)
+{
+    while (this->pending_ > 0 || wait > 0)
+    {
+        Metrics::instance().count(Counter::RingEnters);
+        int submitted = SysEnter(this->fd_, this->pending_, wait, wait > 0 ? IORING_ENTER_GETEVENTS : 0);
+        if (submitted < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw RuntimeError("io_uring_enter failed: " + string(strerror(errno)), __func__);
+        }
+        this->pending_ -= submitted;
+        wait = 0;
+    }
+}
+
+// Метод для получения завершения без ожидания
+bool IoRing::pop(IoCompletion &completion)
+{
+    const unsigned head = *this->cq_head_;
+    if (head == __atomic_load_n(this->cq_tail_, __ATOMIC_ACQUIRE))
+    {
+        return false;
+    }
+
+    const struct io_uring_cqe &cqe = this->cqes_[head & *this->cq_mask_];
+    completion.user_data = cqe.user_data;
+    completion.result = cqe.res;
+    __atomic_store_n(this->cq_head_, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Метод для ожидания завершения
+IoCompletion IoRing::wait()
+{
+    IoCompletion completion;
+    while (!pop(completion))
+    {
+        submit(1);
+    }
+    return completion;
+}
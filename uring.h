@@ -0,0 +1,198 @@
+#pragma once
+
+#include "error.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <sys/uio.h>
+#include <sys/socket.h>
+
+using namespace std;
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+/**
+ * @brief Способ выполнения операций ввода-вывода.
+ */
+enum class IoBackend
+{
+    Blocking, ///< Блокирующие системные вызовы по одному.
+    Uring     ///< Пакетная отправка операций через io_uring.
+};
+
+/**
+ * @brief Разбирает название способа ввода-вывода.
+ *
+ * @param name Название: blocking или uring.
+ * @return Способ ввода-вывода.
+ * @throws RuntimeError Если название неизвестно.
+ */
+IoBackend ParseIoBackend(const string &name);
+
+/**
+ * @brief Результат завершённой операции io_uring.
+ */
+struct IoCompletion
+{
+    uint64_t user_data; ///< Метка операции, заданная при постановке в очередь.
+    int32_t result;     ///< Результат: количество байт или -errno.
+};
+
+/**
+ * @class IoRing
+ * @brief Кольцо io_uring, управляемое напрямую системными вызовами.
+ *
+ * Операции сначала помещаются в очередь отправки без системных вызовов, затем
+ * передаются ядру одним io_uring_enter(). Завершения читаются из очереди
+ * завершений в общей с ядром памяти, тоже без системных вызовов, пока они есть.
+ * Количество одновременно выполняемых операций не должно превышать getCapacity(),
+ * чтобы очередь завершений не переполнялась.
+ */
+class IoRing
+{
+public:
+    /**
+     * @brief Конструктор класса IoRing. Создаёт кольцо и отображает его очереди в память.
+     *
+     * @param entries Размер очереди отправки (округляется ядром до степени двойки).
+     * @throws RuntimeError Если ядро не поддерживает io_uring или кольцо не удалось создать.
+     */
+    explicit IoRing(unsigned entries = 256);
+
+    /**
+     * @brief Деструктор класса IoRing. Освобождает очереди и закрывает кольцо.
+     */
+    ~IoRing();
+
+    IoRing(const IoRing &) = delete;
+    IoRing &operator=(const IoRing &) = delete;
+
+    /**
+     * @brief Проверяет, можно ли создать кольцо io_uring в текущей системе.
+     *
+     * Результат первой проверки запоминается.
+     *
+     * @return true, если io_uring доступен.
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Возвращает размер очереди отправки.
+     *
+     * @return Максимальное количество операций в очереди.
+     */
+    unsigned getCapacity() const;
+
+    /**
+     * @brief Регистрирует буферы для операций чтения в зарегистрированный буфер.
+     *
+     * Ядро закрепляет страницы буферов один раз, а не при каждой операции.
+     *
+     * @param buffers Буферы, индекс в списке используется в prepareReadFixed().
+     * @throws RuntimeError Если ядро отказалось регистрировать буферы.
+     */
+    void registerBuffers(const vector<struct iovec> &buffers);
+
+    /**
+     * @brief Ставит в очередь чтение файла по смещению.
+     *
+     * @param fd Дескриптор файла.
+     * @param dest Буфер назначения.
+     * @param size Количество байт.
+     * @param offset Смещение в файле.
+     * @param user_data Метка операции.
+     */
+    void prepareRead(int fd, void *dest, size_t size, uint64_t offset, uint64_t user_data);
+
+    /**
+     * @brief Ставит в очередь чтение файла в зарегистрированный буфер.
+     *
+     * @param fd Дескриптор файла.
+     * @param dest Адрес внутри зарегистрированного буфера.
+     * @param size Количество байт.
+     * @param offset Смещение в файле.
+     * @param buffer Индекс зарегистрированного буфера.
+     * @param user_data Метка операции.
+     */
+    void prepareReadFixed(int fd, void *dest, size_t size, uint64_t offset, uint16_t buffer, uint64_t user_data);
+
+    /**
+     * @brief Ставит в очередь отправку набора фрагментов в сокет.
+     *
+     * @param socket Сокет.
+     * @param msg Сообщение, которое должно жить до завершения операции.
+     * @param flags Флаги sendmsg().
+     * @param link Выполнять следующую операцию очереди только после этой.
+     * @param user_data Метка операции.
+     */
+    void prepareSendmsg(int socket, const struct msghdr *msg, int flags, bool link, uint64_t user_data);
+
+    /**
+     * @brief Ставит в очередь приём из сокета.
+     *
+     * @param socket Сокет.
+     * @param dest Буфер назначения.
+     * @param size Количество байт.
+     * @param flags Флаги recv().
+     * @param user_data Метка операции.
+     */
+    void prepareRecv(int socket, void *dest, size_t size, int flags, uint64_t user_data);
+
+    /**
+     * @brief Передаёт ядру поставленные операции и при необходимости ждёт завершений.
+     *
+     * @param wait Минимальное количество завершений, которых нужно дождаться.
+     * @throws RuntimeError Если io_uring_enter() завершился ошибкой.
+     */
+    void submit(unsigned wait = 0);
+
+    /**
+     * @brief Забирает одно завершение, если оно уже есть, без системного вызова.
+     *
+     * @param completion Завершённая операция.
+     * @return true, если завершение было в очереди.
+     */
+    bool pop(IoCompletion &completion);
+
+    /**
+     * @brief Ждёт и забирает одно завершение.
+     *
+     * @return Завершённая операция.
+     * @throws RuntimeError Если io_uring_enter() завершился ошибкой.
+     */
+    IoCompletion wait();
+
+private:
+    /**
+     * @brief Освобождает отображения очередей и закрывает кольцо.
+     */
+    void release();
+
+    /**
+     * @brief Возвращает очередную свободную запись очереди отправки.
+     *
+     * @return Очищенная запись.
+     * @throws RuntimeError Если очередь отправки заполнена.
+     */
+    struct io_uring_sqe *nextSqe();
+
+    int fd_;                    ///< Дескриптор кольца.
+    unsigned entries_;          ///< Размер очереди отправки.
+    void *ring_;                ///< Отображение очередей отправки и завершений.
+    size_t ring_size_;          ///< Размер отображения очередей.
+    void *cq_ring_;             ///< Отдельное отображение очереди завершений (если ядро его требует).
+    size_t cq_ring_size_;       ///< Размер отдельного отображения очереди завершений.
+    struct io_uring_sqe *sqes_; ///< Записи очереди отправки.
+    size_t sqes_size_;          ///< Размер отображения записей.
+    unsigned *sq_head_;         ///< Голова очереди отправки (сдвигает ядро).
+    unsigned *sq_tail_;         ///< Хвост очереди отправки (сдвигает приложение).
+    unsigned *sq_mask_;         ///< Маска индексов очереди отправки.
+    unsigned *sq_array_;        ///< Индексы записей в очереди отправки.
+    unsigned *cq_head_;         ///< Голова очереди завершений (сдвигает приложение).
+    unsigned *cq_tail_;         ///< Хвост очереди завершений (сдвигает ядро).
+    unsigned *cq_mask_;         ///< Маска индексов очереди завершений.
+    struct io_uring_cqe *cqes_; ///< Записи очереди завершений.
+    unsigned pending_;          ///< Поставлено в очередь, но не передано ядру.
+};
@@ -0,0 +1,275 @@
+#include "validate.h"
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VALIDATE_X86 1
+#endif
+
+// Последовательный проход по значениям любого типа
+template <typename T>
+static VectorStats ScanScalar(const T *values, size_t size)
+{
+    VectorStats stats = {size, 0, HUGE_VAL, -HUGE_VAL, 0.0};
+    for (size_t i = 0; i < size; ++i)
+    {
+        const double value = static_cast<double>(values[i]);
+        if (!std::isfinite(value))
+        {
+            ++stats.non_finite;
+        }
+        // Сравнения с NaN ложны, поэтому NaN не попадает в минимум и максимум
+        if (value < stats.min)
+        {
+            stats.min = value;
+        }
+        if (value > stats.max)
+        {
+            stats.max = value;
+        }
+        stats.magnitude += fabs(value);
+    }
+    return stats;
+}
+
+// Функция для объединения статистики основной части вектора и его хвоста
+static VectorStats MergeTail(VectorStats stats, const VectorStats &tail)
+{
+    stats.non_finite += tail.non_finite;
+    stats.min = min(stats.min, tail.min);
+    stats.max = max(stats.max, tail.max);
+    stats.magnitude += tail.magnitude;
+    return stats;
+}
+
+#ifdef VALIDATE_X86
+// Проход на SSE2: два независимых набора аккумуляторов по 2 элемента
+static VectorStats ScanSse2(const double *values, size_t size)
+{
+    const __m128d sign = _mm_set1_pd(-0.0);
+    const __m128d inf = _mm_set1_pd(HUGE_VAL);
+    __m128d lo0 = inf, lo1 = inf;
+    __m128d hi0 = _mm_set1_pd(-HUGE_VAL), hi1 = hi0;
+    __m128d mag0 = _mm_setzero_pd(), mag1 = mag0;
+    size_t non_finite = 0;
+
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4)
+    {
+        __m128d a = _mm_loadu_pd(values + i);
+        __m128d b = _mm_loadu_pd(values + i + 2);
+        __m128d abs_a = _mm_andnot_pd(sign, a);
+        __m128d abs_b = _mm_andnot_pd(sign, b);
+        // |v| не меньше бесконечности только для бесконечностей и NaN (неупорядоченное сравнение)
+        __m128d bad = _mm_or_pd(_mm_cmpnlt_pd(abs_a, inf), _mm_cmpnlt_pd(abs_b, inf));
+        if (_mm_movemask_pd(bad) != 0)
+        {
+            non_finite += ScanScalar(values + i, 4).non_finite;
+        }
+        // При NaN в первом операнде min и max возвращают второй, поэтому NaN пропускается
+        lo0 = _mm_min_pd(a, lo0);
+        lo1 = _mm_min_pd(b, lo1);
+        hi0 = _mm_max_pd(a, hi0);
+        hi1 = _mm_max_pd(b, hi1);
+        mag0 = _mm_add_pd(mag0, abs_a);
+        mag1 = _mm_add_pd(mag1, abs_b);
+    }
+
+    double lanes_lo[2], lanes_hi[2], lanes_mag[2];
+    _mm_storeu_pd(lanes_lo, _mm_min_pd(lo0, lo1));
+    _mm_storeu_pd(lanes_hi, _mm_max_pd(hi0, hi1));
+    _mm_storeu_pd(lanes_mag, _mm_add_pd(mag0, mag1));
+    VectorStats stats = {size, non_finite, min(lanes_lo[0], lanes_lo[1]), max(lanes_hi[0], lanes_hi[1]), lanes_mag[0] + lanes_mag[1]};
+    return MergeTail(stats, ScanScalar(values + i, size - i));
+}
+
+// Проход на AVX2: два независимых набора аккумуляторов по 4 элемента
+__attribute__((target("avx2"))) static VectorStats ScanAvx2(const double *values, size_t size)
+{
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d inf = _mm256_set1_pd(HUGE_VAL);
+    __m256d lo0 = inf, lo1 = inf;
+    __m256d hi0 = _mm256_set1_pd(-HUGE_VAL), hi1 = hi0;
+    __m256d mag0 = _mm256_setzero_pd(), mag1 = mag0;
+    size_t non_finite = 0;
+
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        __m256d a = _mm256_loadu_pd(values + i);
+        __m256d b = _mm256_loadu_pd(values + i + 4);
+        __m256d abs_a = _mm256_andnot_pd(sign, a);
+        __m256d abs_b = _mm256_andnot_pd(sign, b);
+        __m256d bad = _mm256_or_pd(_mm256_cmp_pd(abs_a, inf, _CMP_NLT_UQ), _mm256_cmp_pd(abs_b, inf, _CMP_NLT_UQ));
+        if (_mm256_movemask_pd(bad) != 0)
+        {
+            non_finite += ScanScalar(values + i, 8).non_finite;
+        }
+        lo0 = _mm256_min_pd(a, lo0);
+        lo1 = _mm256_min_pd(b, lo1);
+        hi0 = _mm256_max_pd(a, hi0);
+        hi1 = _mm256_max_pd(b, hi1);
+        mag0 = _mm256_add_pd(mag0, abs_a);
+        mag1 = _mm256_add_pd(mag1, abs_b);
+    }
+
+    double lanes_lo[4], lanes_hi[4], lanes_mag[4];
+    _mm256_storeu_pd(lanes_lo, _mm256_min_pd(lo0, lo1));
+    _mm256_storeu_pd(lanes_hi, _mm256_max_pd(hi0, hi1));
+    _mm256_storeu_pd(lanes_mag, _mm256_add_pd(mag0, mag1));
+    VectorStats stats = {size, non_finite, lanes_lo[0], lanes_hi[0], lanes_mag[0]};
+    for (int lane = 1; lane < 4; ++lane)
+    {
+        stats.min = min(stats.min, lanes_lo[lane]);
+        stats.max = max(stats.max, lanes_hi[lane]);
+        stats.magnitude += lanes_mag[lane];
+    }
+    return MergeTail(stats, ScanScalar(values + i, size - i));
+}
+#endif
+
+// Выбор прохода по типу элементов: double проверяется векторными инструкциями
+template <typename T>
+static VectorStats ScanValues(const InputValidator &, const T *values, size_t size)
+{
+    return ScanScalar(values, size);
+}
+
+static VectorStats ScanValues(const InputValidator &validator, const double *values, size_t size)
+{
+    return validator.scan(values, size);
+}
+
+// Конструктор
+InputValidator::InputValidator(Kernel kernel)
+    : kernel_(LocalEngine(Reduction::Sum, kernel).getKernel())
+{
+}
+
+// Метод для сбора статистики одного вектора
+VectorStats InputValidator::scan(const double *values, size_t size) const
+{
+    switch (this->kernel_)
+    {
+#ifdef VALIDATE_X86
+    case Kernel::Avx2:
+        return ScanAvx2(values, size);
+    case Kernel::Sse2:
+        return ScanSse2(values, size);
+#endif
+    default:
+        return ScanScalar(values, size);
+    }
+}
+
+// Метод для проверки всех векторов
+template <typename T>
+ValidationReport InputValidator::validate(const BasicVectorBatch<T> &data) const
+{
+    ValidationReport report;
+    report.vectors.reserve(data.size());
+    report.framing = 0;
+    report.non_finite = 0;
+    report.overflow = 0;
+    report.first_invalid = SIZE_MAX;
+
+    const double limit = static_cast<double>(numeric_limits<T>::max());
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        VectorSpan<T> vec = data[i];
+        VectorStats stats = ScanValues(*this, vec.data(), vec.size());
+
+        // Количество векторов и размер вектора передаются серверу 32-битными полями
+        bool invalid = false;
+        if (i >= UINT32_MAX || vec.size() > UINT32_MAX)
+        {
+            ++report.framing;
+            invalid = true;
+        }
+        if (stats.non_finite > 0)
+        {
+            ++report.non_finite;
+            invalid = true;
+        }
+        else if (stats.magnitude > limit)
+        {
+            ++report.overflow;
+            invalid = true;
+        }
+        if (invalid && report.first_invalid == SIZE_MAX)
+        {
+            report.first_invalid = i;
+        }
+        report.vectors.push_back(stats);
+    }
+    return report;
+}
+
+string InputValidator::getKernelName() const
+{
+    return LocalEngine(Reduction::Sum, this->kernel_).getKernelName();
+}
+
+// Функция для проверки результата
+void CheckValidation(const ValidationReport &report, ElementType type)
+{
+    if (report.first_invalid == SIZE_MAX)
+    {
+        return;
+    }
+
+    vector<string> problems;
+    if (report.framing > 0)
+    {
+        problems.push_back(to_string(report.framing) + " vectors exceed protocol limits");
+    }
+    if (report.non_finite > 0)
+    {
+        problems.push_back(to_string(report.non_finite) + " vectors contain NaN or Inf");
+    }
+    if (report.overflow > 0)
+    {
+        problems.push_back(to_string(report.overflow) + " vectors may overflow " + ElementTypeName(type));
+    }
+
+    string message = "Input validation failed: ";
+    for (size_t i = 0; i < problems.size(); ++i)
+    {
+        message += (i > 0 ? ", " : "") + problems[i];
+    }
+    throw RuntimeError(message + " (first at vector " + to_string(report.first_invalid) + ")", __func__);
+}
+
+// Функция для форматирования статистики
+string FormatStats(const ValidationReport &report, size_t limit)
+{
+    ostringstream out;
+    out << "[\n";
+    size_t shown = min(limit, report.vectors.size());
+    for (size_t i = 0; i < shown; ++i)
+    {
+        const VectorStats &stats = report.vectors[i];
+        out << "  [" << i << "] count=" << stats.count << ", min=" << stats.min << ", max=" << stats.max;
+        if (stats.non_finite > 0)
+        {
+            out << ", non-finite=" << stats.non_finite;
+        }
+        out << "\n";
+    }
+    if (shown < report.vectors.size())
+    {
+        out << "  ... (" << report.vectors.size() - shown << " more vectors)\n";
+    }
+    out << "]";
+    return out.str();
+}
+
+// Явные инстанцирования для поддерживаемых типов элементов
+template ValidationReport InputValidator::validate<int16_t>(const BasicVectorBatch<int16_t> &) const;
+template ValidationReport InputValidator::validate<int32_t>(const BasicVectorBatch<int32_t> &) const;
+template ValidationReport InputValidator::validate<int64_t>(const BasicVectorBatch<int64_t> &) const;
+template ValidationReport InputValidator::validate<float>(const BasicVectorBatch<float> &) const;
+template ValidationReport InputValidator::validate<double>(const BasicVectorBatch<double> &) const;
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "error.h"
+#include "data.h"
+#include "engine.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * @struct VectorStats
+ * @brief Статистика значений одного вектора, собранная при проверке входных данных.
+ */
+struct VectorStats
+{
+    size_t count;      ///< Количество значений.
+    size_t non_finite; ///< Количество значений NaN и бесконечностей.
+    double min;        ///< Наименьшее значение без учёта NaN (+inf для пустого вектора).
+    double max;        ///< Наибольшее значение без учёта NaN (-inf для пустого вектора).
+    double magnitude;  ///< Сумма модулей значений — граница модуля любой частичной суммы.
+};
+
+/**
+ * @struct ValidationReport
+ * @brief Результат проверки входных данных перед отправкой на сервер.
+ */
+struct ValidationReport
+{
+    vector<VectorStats> vectors; ///< Статистика каждого вектора в исходном порядке.
+    size_t framing;              ///< Векторы, которые нельзя передать по протоколу.
+    size_t non_finite;           ///< Векторы, содержащие NaN или бесконечность.
+    size_t overflow;             ///< Векторы, сумма которых может выйти за пределы типа элементов.
+    size_t first_invalid;        ///< Индекс первого вектора с ошибкой (SIZE_MAX, если ошибок нет).
+};
+
+/**
+ * @class InputValidator
+ * @brief Класс для проверки загруженных векторов за один проход по значениям.
+ *
+ * Для каждого вектора считает количество значений, минимум, максимум, сумму
+ * модулей и количество значений NaN и бесконечностей. Вектор с типом элементов
+ * double проверяется векторными инструкциями, выбранными так же, как в
+ * LocalEngine; остальные типы — последовательно. Кроме значений проверяется,
+ * что количество векторов и размер каждого из них помещаются в 32-битные поля
+ * протокола.
+ */
+class InputValidator
+{
+public:
+    /**
+     * @brief Конструктор класса InputValidator.
+     *
+     * @param kernel Набор инструкций.
+     * @throws RuntimeError Если выбранный набор инструкций не поддерживается процессором.
+     */
+    explicit InputValidator(Kernel kernel = Kernel::Auto);
+
+    /**
+     * @brief Проверяет все векторы.
+     *
+     * Методы параметризованы типом элементов T и явно инстанцированы для
+     * int16_t, int32_t, int64_t, float и double. Сумма вектора считается рискованной,
+     * если сумма модулей его значений превышает наибольшее значение типа T.
+     *
+     * @param data Векторы для проверки.
+     * @return Статистика векторов и количество векторов с ошибками.
+     */
+    template <typename T>
+    ValidationReport validate(const BasicVectorBatch<T> &data) const;
+
+    /**
+     * @brief Собирает статистику одного вектора значений double.
+     *
+     * @param values Указатель на значения.
+     * @param size Количество значений.
+     * @return Статистика вектора.
+     */
+    VectorStats scan(const double *values, size_t size) const;
+
+    /**
+     * @brief Возвращает название выбранного набора инструкций.
+     *
+     * @return Название набора инструкций.
+     */
+    string getKernelName() const;
+
+private:
+    Kernel kernel_; ///< Выбранный набор инструкций.
+};
+
+/**
+ * @brief Проверяет результат проверки входных данных.
+ *
+ * @param report Результат проверки.
+ * @param type Тип элементов, для которого выполнялась проверка.
+ * @throws RuntimeError Если хотя бы один вектор не прошёл проверку.
+ */
+void CheckValidation(const ValidationReport &report, ElementType type);
+
+/**
+ * @brief Форматирует статистику векторов для вывода в журнал.
+ *
+ * @param report Результат проверки.
+ * @param limit Максимальное количество выводимых векторов.
+ * @return Строки вида "[i] count=..., min=..., max=...".
+ */
+string FormatStats(const ValidationReport &report, size_t limit = SIZE_MAX);